@@ -0,0 +1,407 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "problems/jugs.hpp"
+#include "misc/types.hpp"
+#include "misc/benchmark_utils.hpp"
+#include "misc/cli_utils.hpp"
+#include "misc/instrumentation.hpp"
+#include "misc/common_functions.hpp"
+#include "searches/algorithms.hpp"
+
+// Неинтерактивный бенчмарк: перебирает сетку конфигураций сосудов и целей,
+// прогревает и многократно замеряет каждый алгоритм и пишет отчет в JSON
+// или CSV, пригодный для сравнения между версиями.
+
+namespace {
+
+struct BenchmarkCase {
+    std::vector<int> capacities;
+    int target;
+};
+
+struct BenchmarkRecord {
+    std::vector<int> capacities;
+    int target;
+    std::string algorithm;
+    bool found;
+    size_t pathLength;
+    long long pathCost;
+    uint32_t visited;
+    TimingSummary timing;
+    double nodesPerSecond;
+    long peakRssKb;
+    SearchStats stats; // последнего замеряемого прогона, если собрано с инструментированием
+};
+
+struct BenchmarkConfig {
+    std::vector<BenchmarkCase> cases;
+    std::vector<std::string> algorithms;
+    int warmup = 2;
+    int repeat = 10;
+    unsigned threads = 0;
+    MoveCosts costs;
+    std::optional<int> lookahead;
+    std::string patternsPath;
+    size_t transpositionEntries = SearchOptions{}.transpositionEntries;
+    size_t externalBufferBytes = SearchOptions{}.externalBufferBytes;
+    std::string externalDirectory;
+    std::string cachePath;
+    bool solvableOnly = false;
+    std::string format = "json";
+    std::string output;
+};
+
+void printUsage() {
+    std::cerr <<
+        "Использование: benchmark [опции]\n"
+        "  --case \"<емкости> | <цели>\"  случай сетки: каждое число может быть\n"
+        "                                 диапазоном lo:hi[:step], емкости дают\n"
+        "                                 декартово произведение, число полей\n"
+        "                                 до '|' задает число сосудов\n"
+        "  --config FILE                  случаи из файла, по одному в строке,\n"
+        "                                 '#' начинает комментарий\n"
+        "  --algorithms a,b,...           подмножество алгоритмов (по умолчанию все)\n"
+        "  --warmup N                     прогревочные прогоны (2)\n"
+        "  --repeat N                     замеряемые прогоны (10)\n"
+        "  --threads N                    потоки параллельных алгоритмов (0 = все ядра)\n"
+        "  --costs F,E,P,L                стоимость наполнения, опустошения, переливания\n"
+        "                                 и каждого литра (1,1,1,0)\n"
+        "  --lookahead K                  глубина просмотра эвристики A*, IDA*, HDA* (0-3, 1)\n"
+        "  --transpositions N             ячеек таблицы транспозиций IDA*/IDDFS (65536, 0 — без нее)\n"
+        "  --external-buffer MB           буфер внешнего BFS в мегабайтах (64)\n"
+        "  --external-dir DIR             каталог файлов внешнего BFS (системный tmp)\n"
+        "  --cache DIR                    каталог кэша решений для cached_bfs\n"
+        "  --pdb FILE                     база шаблонов для astar_pdb (см. pdb_build)\n"
+        "  --solvable-only                пропускать недостижимые цели\n"
+        "  --format json|csv              формат отчета (json)\n"
+        "  --output FILE                  файл отчета (по умолчанию stdout)\n";
+}
+
+auto parseFields(const std::string& text) -> std::vector<std::vector<int>> {
+    std::vector<std::vector<int>> fields;
+    std::istringstream in(text);
+    for (std::string token; in >> token;) {
+        fields.push_back(parseRange(token));
+    }
+    return fields;
+}
+
+// "<емкости> | <цели>" -> все сочетания емкостей, каждое со всеми целями.
+void expandCase(const std::string& spec, std::vector<BenchmarkCase>& cases) {
+    size_t bar = spec.find('|');
+    if (bar == std::string::npos) {
+        throw std::invalid_argument("в случае нет '|': " + spec);
+    }
+    std::vector<std::vector<int>> capacityFields = parseFields(spec.substr(0, bar));
+    std::vector<std::vector<int>> targetFields = parseFields(spec.substr(bar + 1));
+    if (capacityFields.empty() || targetFields.empty()) {
+        throw std::invalid_argument("в случае нужны емкости и цели: " + spec);
+    }
+
+    std::vector<int> targets;
+    for (const auto& field : targetFields) {
+        targets.insert(targets.end(), field.begin(), field.end());
+    }
+
+    std::vector<size_t> position(capacityFields.size(), 0);
+    while (true) {
+        std::vector<int> capacities;
+        for (size_t i = 0; i < capacityFields.size(); ++i) {
+            capacities.push_back(capacityFields[i][position[i]]);
+        }
+        for (int target : targets) {
+            cases.push_back({capacities, target});
+        }
+
+        size_t k = capacityFields.size();
+        while (k-- > 0) {
+            if (++position[k] < capacityFields[k].size()) {
+                break;
+            }
+            position[k] = 0;
+        }
+        if (k == static_cast<size_t>(-1)) {
+            break;
+        }
+    }
+}
+
+auto parseArguments(int argc, char** argv) -> BenchmarkConfig {
+    BenchmarkConfig config;
+    auto value = [&](int& i) -> std::string {
+        if (i + 1 >= argc) {
+            throw std::invalid_argument(std::string("нет значения для ") + argv[i]);
+        }
+        return argv[++i];
+    };
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--case") {
+            expandCase(value(i), config.cases);
+        } else if (arg == "--config") {
+            std::string path = value(i);
+            std::ifstream file(path);
+            if (!file) {
+                throw std::invalid_argument("не удалось открыть " + path);
+            }
+            for (std::string line; std::getline(file, line);) {
+                line = line.substr(0, line.find('#'));
+                if (line.find_first_not_of(" \t\r") != std::string::npos) {
+                    expandCase(line, config.cases);
+                }
+            }
+        } else if (arg == "--algorithms") {
+            config.algorithms = parseAlgorithmList(value(i), jugsAlgorithmNames());
+        } else if (arg == "--warmup") {
+            config.warmup = std::stoi(value(i));
+            if (config.warmup < 0) {
+                throw std::invalid_argument("число прогревочных прогонов не может быть отрицательным");
+            }
+        } else if (arg == "--repeat") {
+            config.repeat = std::max(1, std::stoi(value(i)));
+        } else if (arg == "--threads") {
+            config.threads = static_cast<unsigned>(std::stoul(value(i)));
+        } else if (arg == "--costs") {
+            config.costs = parseCosts(value(i));
+        } else if (arg == "--lookahead") {
+            config.lookahead = std::stoi(value(i));
+            if (*config.lookahead < 0 || *config.lookahead > JugsProblem::kMaxHeuristicLookahead) {
+                throw std::invalid_argument("глубина просмотра эвристики — от 0 до "
+                                            + std::to_string(JugsProblem::kMaxHeuristicLookahead));
+            }
+        } else if (arg == "--transpositions") {
+            config.transpositionEntries = std::stoul(value(i));
+        } else if (arg == "--external-buffer") {
+            config.externalBufferBytes = std::stoul(value(i)) << 20;
+        } else if (arg == "--external-dir") {
+            config.externalDirectory = value(i);
+        } else if (arg == "--cache") {
+            config.cachePath = value(i);
+        } else if (arg == "--pdb") {
+            config.patternsPath = value(i);
+        } else if (arg == "--solvable-only") {
+            config.solvableOnly = true;
+        } else if (arg == "--format") {
+            config.format = value(i);
+            if (config.format != "json" && config.format != "csv") {
+                throw std::invalid_argument("неизвестный формат: " + config.format);
+            }
+        } else if (arg == "--output") {
+            config.output = value(i);
+        } else if (arg == "--help" || arg == "-h") {
+            printUsage();
+            std::exit(0);
+        } else {
+            throw std::invalid_argument("неизвестный параметр: " + arg);
+        }
+    }
+
+    if (config.cases.empty()) {
+        expandCase("97:997:300 101:1009:302 | 1:49:12", config.cases);
+    }
+    return config;
+}
+
+auto isSelected(const BenchmarkConfig& config, const std::string& name) -> bool {
+    return config.algorithms.empty()
+           || std::find(config.algorithms.begin(), config.algorithms.end(), name) != config.algorithms.end();
+}
+
+auto runCase(const BenchmarkConfig& config, const PatternDatabase* patterns, SolutionCache* cache,
+             SearchWorkspace& workspace, const BenchmarkCase& benchCase,
+             std::vector<BenchmarkRecord>& records) -> void {
+    JugsProblem problem(benchCase.capacities, benchCase.target, config.costs);
+    if (config.lookahead) {
+        problem.setHeuristicLookahead(*config.lookahead);
+    }
+    if (config.solvableOnly && !problem.isSolvable()) {
+        return;
+    }
+
+    SearchOptions options;
+    options.threads = config.threads;
+    options.patterns = patterns;
+    options.cache = cache;
+    options.transpositionEntries = config.transpositionEntries;
+    options.externalBufferBytes = config.externalBufferBytes;
+    options.externalDirectory = config.externalDirectory;
+    options.workspace = &workspace;
+
+    for (const JugsAlgorithm& algorithm : jugsAlgorithms(problem, options)) {
+        if (!isSelected(config, algorithm.name)) {
+            continue;
+        }
+
+        resetPeakRss();
+        SearchResult<JugsProblem::State> result;
+        SearchStats stats;
+        std::vector<double> times;
+        times.reserve(config.repeat);
+
+        for (int run = 0; run < config.warmup + config.repeat; ++run) {
+            workspace.reset();
+            StateStore& store = workspace.store(problem.stateCount());
+            stats = {};
+            options.stats = kSearchInstrumentation ? &stats : nullptr;
+            auto startTime = std::chrono::high_resolution_clock::now();
+            result = algorithm.function(problem, store, options);
+            auto endTime = std::chrono::high_resolution_clock::now();
+            if (run >= config.warmup) {
+                times.push_back(std::chrono::duration<double>(endTime - startTime).count());
+            }
+        }
+
+        TimingSummary timing = summarize(times);
+        double nodesPerSecond = timing.median > 0 ? result.visitedNodes / timing.median : 0;
+        records.push_back({benchCase.capacities, benchCase.target, algorithm.name,
+                           result.pathFound, result.path.size(), pathCost(problem, result.path),
+                           result.visitedNodes,
+                           timing, nodesPerSecond, peakRssKb(), stats});
+    }
+}
+
+void writeJson(std::ostream& out, const BenchmarkConfig& config, const std::vector<BenchmarkRecord>& records) {
+    out << std::setprecision(9);
+    out << "{\n  \"warmup\": " << config.warmup
+        << ",\n  \"repeat\": " << config.repeat
+        << ",\n  \"threads\": " << config.threads
+        << ",\n  \"costs\": {\"fill\": " << config.costs.fill
+        << ", \"empty\": " << config.costs.empty
+        << ", \"pour\": " << config.costs.pour
+        << ", \"per_liter\": " << config.costs.perLiter << "}"
+        << ",\n  \"instrumentation\": " << (kSearchInstrumentation ? "true" : "false")
+        << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < records.size(); ++i) {
+        const BenchmarkRecord& r = records[i];
+        out << "    {\"capacities\": [";
+        for (size_t j = 0; j < r.capacities.size(); ++j) {
+            out << (j ? ", " : "") << r.capacities[j];
+        }
+        out << "], \"target\": " << r.target
+            << ", \"algorithm\": \"" << r.algorithm << "\""
+            << ", \"found\": " << (r.found ? "true" : "false")
+            << ", \"path_length\": " << r.pathLength
+            << ", \"path_cost\": " << r.pathCost
+            << ", \"visited\": " << r.visited
+            << ", \"min_s\": " << r.timing.min
+            << ", \"median_s\": " << r.timing.median
+            << ", \"p95_s\": " << r.timing.p95
+            << ", \"p99_s\": " << r.timing.p99
+            << ", \"mean_s\": " << r.timing.mean
+            << ", \"nodes_per_s\": " << r.nodesPerSecond
+            << ", \"peak_rss_kb\": " << r.peakRssKb;
+        if constexpr (kSearchInstrumentation) {
+            const SearchStats& st = r.stats;
+            out << ", \"stats\": {\"expansions\": " << st.expansions
+                << ", \"generated\": " << st.generated
+                << ", \"duplicates\": " << st.duplicates
+                << ", \"stale_pops\": " << st.stalePops
+                << ", \"peak_open_size\": " << st.peakOpenSize
+                << ", \"probes\": " << st.probes
+                << ", \"bytes_allocated\": " << st.bytesAllocated
+                << ", \"successor_s\": " << st.successorSeconds
+                << ", \"goal_test_s\": " << st.goalTestSeconds
+                << ", \"reconstruction_s\": " << st.reconstructionSeconds << "}";
+        }
+        out << "}" << (i + 1 < records.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+void writeCsv(std::ostream& out, const std::vector<BenchmarkRecord>& records) {
+    out << std::setprecision(9);
+    out << "capacities,target,algorithm,found,path_length,path_cost,visited,"
+           "min_s,median_s,p95_s,p99_s,mean_s,nodes_per_s,peak_rss_kb";
+    if constexpr (kSearchInstrumentation) {
+        out << ",expansions,generated,duplicates,stale_pops,peak_open_size,probes,"
+               "bytes_allocated,successor_s,goal_test_s,reconstruction_s";
+    }
+    out << "\n";
+    for (const BenchmarkRecord& r : records) {
+        for (size_t j = 0; j < r.capacities.size(); ++j) {
+            out << (j ? " " : "") << r.capacities[j];
+        }
+        out << "," << r.target << "," << r.algorithm << "," << (r.found ? 1 : 0)
+            << "," << r.pathLength << "," << r.pathCost << "," << r.visited
+            << "," << r.timing.min << "," << r.timing.median
+            << "," << r.timing.p95 << "," << r.timing.p99 << "," << r.timing.mean
+            << "," << r.nodesPerSecond << "," << r.peakRssKb;
+        if constexpr (kSearchInstrumentation) {
+            const SearchStats& st = r.stats;
+            out << "," << st.expansions << "," << st.generated << "," << st.duplicates
+                << "," << st.stalePops << "," << st.peakOpenSize << "," << st.probes
+                << "," << st.bytesAllocated << "," << st.successorSeconds
+                << "," << st.goalTestSeconds << "," << st.reconstructionSeconds;
+        }
+        out << "\n";
+    }
+}
+
+} // namespace
+
+auto main(int argc, char** argv) -> int {
+    BenchmarkConfig config;
+    try {
+        config = parseArguments(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка: " << e.what() << "\n";
+        printUsage();
+        return 1;
+    }
+
+    std::optional<PatternDatabase> patterns;
+    if (!config.patternsPath.empty()) {
+        try {
+            patterns.emplace(config.patternsPath);
+        } catch (const std::exception& e) {
+            std::cerr << "Ошибка: " << e.what() << "\n";
+            return 1;
+        }
+    }
+
+    std::optional<SolutionCache> cache;
+    if (!config.cachePath.empty()) {
+        cache.emplace(config.cachePath);
+    }
+
+    // Одно рабочее пространство на все прогоны: замеряется поиск, а не аллокатор
+    SearchWorkspace workspace;
+    std::vector<BenchmarkRecord> records;
+    for (const BenchmarkCase& benchCase : config.cases) {
+        try {
+            runCase(config, patterns ? &*patterns : nullptr, cache ? &*cache : nullptr, workspace, benchCase,
+                    records);
+        } catch (const std::exception& e) {
+            std::cerr << "Пропуск случая: " << e.what() << "\n";
+        }
+    }
+
+    std::ofstream file;
+    if (!config.output.empty()) {
+        file.open(config.output);
+        if (!file) {
+            std::cerr << "Ошибка: не удалось создать файл " << config.output << "\n";
+            return 1;
+        }
+    }
+    std::ostream& out = config.output.empty() ? std::cout : file;
+
+    if (config.format == "csv") {
+        writeCsv(out, records);
+    } else {
+        writeJson(out, config, records);
+    }
+
+    return 0;
+}
@@ -3,31 +3,106 @@
 #include <boost/functional/hash.hpp>
 #include <boost/graph/graphviz.hpp>
 #include <iostream>
+#include <limits>
 #include <vector>
 #include <numeric>
+#include <optional>
+#include <sstream>
+#include <string>
 
-#include "searches/bfs.hpp"
+#include "problems/jugs.hpp"
 #include "misc/types.hpp"
-#include "searches/ucs.hpp"
-#include "searches/dfs.hpp"
-#include "searches/astar.hpp"
+#include "misc/common_functions.hpp"
+#include "searches/algorithms.hpp"
+#include "searches/volume_table.hpp"
 
 #include <iomanip>
 
+// Пакетный режим: один обход пространства состояний на конфигурацию
+// сосудов, затем ответы на все цели из таблицы объёмов.
+auto runVolumeQueries(const JugsProblem& problem, const std::vector<int>& targets, bool log) -> void {
+    auto buildStart = std::chrono::high_resolution_clock::now();
+    VolumeTable table(problem);
+    auto buildEnd = std::chrono::high_resolution_clock::now();
+    std::cout << "=== ТАБЛИЦА ОБЪЕМОВ ===" << std::endl;
+    std::cout << "Построена за " << std::fixed << std::setprecision(6)
+              << std::chrono::duration<double>(buildEnd - buildStart).count() << " сек, "
+              << "посещено узлов: " << table.visitedNodes() << std::endl << std::endl;
+
+    for (int target : targets) {
+        auto queryStart = std::chrono::high_resolution_clock::now();
+        auto [pathFound, path, visitedNodes] = table.query(target);
+        auto queryEnd = std::chrono::high_resolution_clock::now();
+        double time = std::chrono::duration<double>(queryEnd - queryStart).count();
+
+        std::cout << "=== ЦЕЛЬ " << target << " ===" << std::endl;
+        if (pathFound) {
+            std::cout << "Путь найден (" << std::fixed << std::setprecision(6) << time << " сек):" << std::endl;
+            std::cout << "Длина пути: " << path.size() << std::endl;
+            if (log) {
+                std::cout << "Путь: " << std::endl;
+                for (auto& e : path) {
+                    problem.print(std::cout, e);
+                    std::cout << std::endl;
+                }
+            }
+        } else {
+            std::cout << "Решение не найдено (" << std::fixed << std::setprecision(6) << time << " сек)." << std::endl;
+        }
+        std::cout << std::endl;
+    }
+}
+
+// Портфель: алгоритмы одновременно, ответ первого подходящего.
+auto runPortfolioQuery(const JugsProblem& problem, const std::vector<JugsAlgorithm>& algorithms,
+                       PortfolioQuality quality, const SearchOptions& options, bool log) -> void {
+    auto [result, winner, time] = runPortfolio(problem, jugsPortfolio(problem, algorithms, quality), options);
+
+    std::cout << "=== ПОРТФЕЛЬ ===" << std::endl;
+    if (!result.pathFound) {
+        std::cout << "Решение не найдено (" << std::fixed << std::setprecision(6) << time << " сек)." << std::endl;
+        return;
+    }
+    std::cout << "Первым ответил " << winner << " (" << std::fixed << std::setprecision(6) << time << " сек)" << std::endl;
+    std::cout << "Длина пути: " << result.path.size() << std::endl;
+    std::cout << "Стоимость пути: " << pathCost(problem, result.path) << std::endl;
+    std::cout << "Посещено узлов: " << result.visitedNodes << std::endl;
+    if (log) {
+        std::cout << "Путь: " << std::endl;
+        for (auto& e : result.path) {
+            problem.print(std::cout, e);
+            std::cout << std::endl;
+        }
+    }
+}
 
 auto main() -> int {
-    int capacityA = 4;
-    int capacityB = 3;
+    std::vector<int> capacities;
+    std::vector<int> targets;
     int targetVolume = 2;
     bool log = false;
     bool benchmark = false;
     
-    std::cout << "Введите емкость сосуда A: ";
-    std::cin >> capacityA;
-    std::cout << "Введите емкость сосуда B: ";
-    std::cin >> capacityB;
-    std::cout << "Введите целевой объем: ";
-    std::cin >> targetVolume;
+    std::cout << "Введите емкости сосудов через пробел: ";
+    std::string capacitiesLine;
+    std::getline(std::cin, capacitiesLine);
+    std::istringstream capacitiesStream(capacitiesLine);
+    for (int capacity; capacitiesStream >> capacity;) {
+        capacities.push_back(capacity);
+    }
+    if (capacities.empty()) {
+        capacities = {4, 3};
+    }
+    std::cout << "Введите целевой объем (несколько через пробел — пакетный режим): ";
+    std::string targetsLine;
+    std::getline(std::cin, targetsLine);
+    std::istringstream targetsStream(targetsLine);
+    for (int target; targetsStream >> target;) {
+        targets.push_back(target);
+    }
+    if (!targets.empty()) {
+        targetVolume = targets.front();
+    }
     
     std::cout << "Логи (y/n): ";
     char logc = 'n';
@@ -42,14 +117,78 @@ auto main() -> int {
     if (benchc == 'y') {
         benchmark = true;
     }
+
+    SearchWorkspace workspace;
+    SearchOptions options;
+    options.workspace = &workspace;
+    std::cout << "Потоков для параллельного BFS (0 = все ядра): ";
+    std::cin >> options.threads;
+
+    // Пустая строка или конец ввода — каждый ход стоит 1
+    std::cout << "Стоимость ходов: наполнить вылить перелить за_литр (пусто = по 1 за ход): ";
+    MoveCosts costs;
+    std::string costsLine;
+    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    std::getline(std::cin, costsLine);
+    std::istringstream costsStream(costsLine);
+    costsStream >> costs.fill >> costs.empty >> costs.pour >> costs.perLiter;
+
+    // База шаблонов строится утилитой pdb_build под конфигурацию сосудов
+    std::cout << "Файл базы шаблонов для A* (пусто = без нее): ";
+    std::string patternsPath;
+    std::getline(std::cin, patternsPath);
+
+    std::cout << "Каталог кэша решений (пусто = без кэша): ";
+    std::string cachePath;
+    std::getline(std::cin, cachePath);
+
+    std::cout << "Портфель алгоритмов: any — первый путь, optimal — первый оптимальный (пусто = по очереди): ";
+    std::string portfolioMode;
+    std::getline(std::cin, portfolioMode);
     std::cout << "\n";
 
-    State initial(capacityA, 0);
+    JugsProblem problem(capacities, targetVolume, costs);
+
+    std::optional<SolutionCache> cache;
+    if (!cachePath.empty()) {
+        options.cache = &cache.emplace(cachePath);
+    }
+
+    std::optional<PatternDatabase> patterns;
+    if (!patternsPath.empty()) {
+        try {
+            patterns.emplace(patternsPath);
+            if (patterns->matches(problem)) {
+                options.patterns = &*patterns;
+            } else {
+                std::cout << "База шаблонов построена для других сосудов, стоимостей или целей." << std::endl;
+            }
+        } catch (const std::exception& e) {
+            std::cout << "Ошибка: " << e.what() << std::endl;
+        }
+    }
+
+    if (targets.size() > 1) {
+        runVolumeQueries(problem, targets, log);
+        return 0;
+    }
+
+    // Недостижимую цель отсекаем по НОД емкостей, не запуская поиск
+    if (!problem.isSolvable()) {
+        std::cout << "Решение не найдено: объем " << targetVolume
+                  << " не кратен НОД емкостей или больше наибольшего сосуда." << std::endl;
+        return 0;
+    }
 
-    // Списки алгоритмов и их имен
-    std::vector<AlgorithmFunction> algorithms = {bfs, ucs, dfs, astar};
-    std::vector<std::string> algoNames = {"bfs", "ucs", "dfs", "astar"};
-    std::vector<std::string> displayNames = {"BFS", "UCS", "DFS", "A*"};
+    // Список алгоритмов и их имен
+    std::vector<JugsAlgorithm> algorithms = jugsAlgorithms(problem, options);
+
+    if (portfolioMode == "any" || portfolioMode == "optimal") {
+        runPortfolioQuery(problem, algorithms,
+                          portfolioMode == "any" ? PortfolioQuality::Any : PortfolioQuality::Optimal,
+                          options, log);
+        return 0;
+    }
 
     if (benchmark) {
         std::vector<std::vector<double>> allTimes(algorithms.size());
@@ -58,19 +197,17 @@ auto main() -> int {
         for (int run = 0; run < 10; ++run) {
             for (size_t i = 0; i < algorithms.size(); ++i) {
                 auto [success, time, pathLen, visited] =                 runAlgorithm(
-                    algorithms[i],
-                    algoNames[i],
-                    initial,
-                    capacityA,
-                    capacityB,
-                    targetVolume,
+                    algorithms[i].function,
+                    algorithms[i].name,
+                    problem,
+                    options,
                     false,  // Для бенчмарка логи отключить надо
                     true // Вообще все логи убираем (тихий режим)
                 );
 
                 if (!success) {
                     allRunsSuccessful = false;
-                    std::cout << "Ошибка: алгоритм " << displayNames[i] << "не нашел путь в прогоне " <<  (run + 1) << "\n";
+                    std::cout << "Ошибка: алгоритм " << algorithms[i].displayName << "не нашел путь в прогоне " <<  (run + 1) << "\n";
                 }
                 allTimes[i].push_back(time);
             }
@@ -80,7 +217,7 @@ auto main() -> int {
             std::cout << "=== ОТЧЕТ БЕНЧМАРКА === \n";
             for (size_t i = 0; i < algorithms.size(); ++i) {
                 double avgTime = std::accumulate(allTimes[i].begin(), allTimes[i].end(), 0.0) / allTimes[i].size();
-                std::cout << displayNames[i] << ": среднее время = " 
+                std::cout << algorithms[i].displayName << ": среднее время = " 
                       << std::fixed << std::setprecision(6) 
                       << avgTime << " сек" << std::endl;
             }
@@ -88,18 +225,24 @@ auto main() -> int {
             std::cout << "Бенчмарк не может быть завершен: не все прогоны были успешными" << std::endl;
         }
     } else {
+        std::vector<size_t> pathLengths(algorithms.size());
         for (size_t i = 0; i < algorithms.size(); ++i) {
-            std::cout << "=== ЗАПУСК " << displayNames[i] << " ===" << std::endl;
-            runAlgorithm(
-                algorithms[i],
-                algoNames[i],
-                initial,
-                capacityA,
-                capacityB,
-                targetVolume,
+            std::cout << "=== ЗАПУСК " << algorithms[i].displayName << " ===" << std::endl;
+            auto [success, time, pathLen, visited] = runAlgorithm(
+                algorithms[i].function,
+                algorithms[i].name,
+                problem,
+                options,
                 log,
                 false
             );
+            pathLengths[i] = pathLen;
+        }
+
+        // Сверка формулы с BFS: оба пути должны быть кратчайшими
+        if (algorithms.back().name == "closed_form" && pathLengths.back() != pathLengths.front()) {
+            std::cout << "Ошибка: длина пути по формуле (" << pathLengths.back()
+                      << ") не совпадает с BFS (" << pathLengths.front() << ")" << std::endl;
         }
     }
 
@@ -0,0 +1,49 @@
+#ifndef ATOMIC_BITSET_HPP
+#define ATOMIC_BITSET_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// Битовое множество над плотным индексом состояний, которое могут
+// одновременно менять несколько потоков. Все операции relaxed: порядок
+// между уровнями поиска обеспечивает барьер.
+class AtomicBitset {
+public:
+    explicit AtomicBitset(size_t bits) : words_((bits + 63) / 64) {}
+
+    auto wordCount() const -> size_t { return words_.size(); }
+
+    auto test(size_t i) const -> bool {
+        return words_[i >> 6].load(std::memory_order_relaxed) & bit(i);
+    }
+
+    void set(size_t i) {
+        words_[i >> 6].fetch_or(bit(i), std::memory_order_relaxed);
+    }
+
+    // Возвращает true, если бит был выставлен этим вызовом. Предварительное
+    // чтение отсекает дорогой fetch_or для уже посещённых состояний.
+    auto testAndSet(size_t i) -> bool {
+        std::atomic<uint64_t>& word = words_[i >> 6];
+        if (word.load(std::memory_order_relaxed) & bit(i)) {
+            return false;
+        }
+        return !(word.fetch_or(bit(i), std::memory_order_relaxed) & bit(i));
+    }
+
+    // Забирает слово целиком, обнуляя его.
+    auto takeWord(size_t w) -> uint64_t {
+        if (words_[w].load(std::memory_order_relaxed) == 0) {
+            return 0;
+        }
+        return words_[w].exchange(0, std::memory_order_relaxed);
+    }
+
+private:
+    static auto bit(size_t i) -> uint64_t { return 1ULL << (i & 63); }
+
+    std::vector<std::atomic<uint64_t>> words_;
+};
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef BENCHMARK_UTILS_HPP
+#define BENCHMARK_UTILS_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <numeric>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+
+// Сводка по серии замеров времени в секундах.
+struct TimingSummary {
+    double min = 0;
+    double median = 0;
+    double p95 = 0;
+    double p99 = 0;
+    double mean = 0;
+};
+
+// Перцентиль по ближайшему рангу на отсортированной выборке.
+inline auto percentile(const std::vector<double>& sorted, double q) -> double {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t rank = static_cast<size_t>(std::ceil(q * static_cast<double>(sorted.size())));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+inline auto summarize(std::vector<double> times) -> TimingSummary {
+    TimingSummary summary;
+    if (times.empty()) {
+        return summary;
+    }
+    std::sort(times.begin(), times.end());
+    summary.min = times.front();
+    summary.median = percentile(times, 0.5);
+    summary.p95 = percentile(times, 0.95);
+    summary.p99 = percentile(times, 0.99);
+    summary.mean = std::accumulate(times.begin(), times.end(), 0.0) / static_cast<double>(times.size());
+    return summary;
+}
+
+// Сбрасывает пиковый RSS процесса, чтобы следующий замер относился только
+// к одному случаю. Работает на Linux; в остальных системах пик копится.
+inline void resetPeakRss() {
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    if (clearRefs) {
+        clearRefs << "5";
+    }
+}
+
+// Пиковый RSS процесса в килобайтах.
+inline auto peakRssKb() -> long {
+    std::ifstream status("/proc/self/status");
+    for (std::string line; std::getline(status, line);) {
+        if (line.rfind("VmHWM:", 0) == 0) {
+            return std::stol(line.substr(6));
+        }
+    }
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef BOUNDED_QUEUE_HPP
+#define BOUNDED_QUEUE_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+// Очередь заданий ограниченной длины между читателями запросов и пулом
+// рабочих потоков. Полная очередь блокирует push — так давление
+// передаётся назад, вплоть до буфера сокета клиента. Счётчики глубины
+// доступны для метрик.
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity_(std::max<size_t>(capacity, 1)) {}
+
+    // Ждёт свободного места; false, если очередь уже закрыта.
+    auto push(T item) -> bool {
+        std::unique_lock lock(mutex_);
+        if (items_.size() >= capacity_ && !closed_) {
+            blockedPushes_++;
+            notFull_.wait(lock, [&] { return items_.size() < capacity_ || closed_; });
+        }
+        if (closed_) {
+            return false;
+        }
+        items_.push_back(std::move(item));
+        peakSize_ = std::max<uint64_t>(peakSize_, items_.size());
+        notEmpty_.notify_one();
+        return true;
+    }
+
+    // Ждёт задания; пусто, когда очередь закрыта и опустела.
+    auto pop() -> std::optional<T> {
+        std::unique_lock lock(mutex_);
+        notEmpty_.wait(lock, [&] { return !items_.empty() || closed_; });
+        if (items_.empty()) {
+            return std::nullopt;
+        }
+        T item = std::move(items_.front());
+        items_.pop_front();
+        notFull_.notify_one();
+        return item;
+    }
+
+    // Новые задания больше не принимаются, оставшиеся дорабатываются.
+    void close() {
+        std::lock_guard lock(mutex_);
+        closed_ = true;
+        notEmpty_.notify_all();
+        notFull_.notify_all();
+    }
+
+    auto capacity() const -> size_t { return capacity_; }
+
+    auto size() const -> size_t {
+        std::lock_guard lock(mutex_);
+        return items_.size();
+    }
+
+    auto peakSize() const -> uint64_t {
+        std::lock_guard lock(mutex_);
+        return peakSize_;
+    }
+
+    // Сколько раз производитель ждал места в очереди.
+    auto blockedPushes() const -> uint64_t {
+        std::lock_guard lock(mutex_);
+        return blockedPushes_;
+    }
+
+private:
+    size_t capacity_;
+    mutable std::mutex mutex_;
+    std::condition_variable notEmpty_;
+    std::condition_variable notFull_;
+    std::deque<T> items_;
+    bool closed_ = false;
+    uint64_t peakSize_ = 0;
+    uint64_t blockedPushes_ = 0;
+};
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef CLI_UTILS_HPP
+#define CLI_UTILS_HPP
+
+#include "../problems/jugs.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Разбор аргументов, общий для неинтерактивных утилит.
+
+// Число или диапазон lo:hi[:step] -> список значений.
+inline auto parseRange(const std::string& token) -> std::vector<int> {
+    std::vector<int> parts;
+    std::istringstream in(token);
+    for (std::string part; std::getline(in, part, ':');) {
+        if (part.empty()) {
+            throw std::invalid_argument("пустое поле диапазона: " + token);
+        }
+        parts.push_back(std::stoi(part));
+    }
+    if (parts.empty() || parts.size() > 3 || token.back() == ':') {
+        throw std::invalid_argument("неверный диапазон: " + token);
+    }
+    int lo = parts[0];
+    int hi = parts.size() > 1 ? parts[1] : lo;
+    int step = parts.size() > 2 ? parts[2] : 1;
+    if (step <= 0) {
+        throw std::invalid_argument("шаг диапазона должен быть положительным: " + token);
+    }
+    if (lo > hi) {
+        throw std::invalid_argument("начало диапазона больше конца: " + token);
+    }
+    std::vector<int> values;
+    // Шаг считается в 64 битах: у конца диапазона около INT_MAX int переполнился бы
+    for (int64_t v = lo; v <= hi; v += step) {
+        values.push_back(static_cast<int>(v));
+    }
+    return values;
+}
+
+// "a,b,..." -> список алгоритмов; пустое или неизвестное имя — ошибка.
+inline auto parseAlgorithmList(const std::string& text, const std::vector<std::string>& known)
+    -> std::vector<std::string> {
+    std::vector<std::string> names;
+    std::istringstream in(text);
+    for (std::string name; std::getline(in, name, ',');) {
+        if (std::find(known.begin(), known.end(), name) == known.end()) {
+            throw std::invalid_argument("неизвестный алгоритм: '" + name + "'");
+        }
+        names.push_back(name);
+    }
+    if (names.empty() || text.back() == ',') {
+        throw std::invalid_argument("пустой список алгоритмов: " + text);
+    }
+    return names;
+}
+
+// "F,E,P,L" -> стоимость наполнения, опустошения, переливания и литра.
+inline auto parseCosts(const std::string& text) -> MoveCosts {
+    std::istringstream in(text);
+    std::vector<int> parts;
+    for (std::string part; std::getline(in, part, ',');) {
+        parts.push_back(std::stoi(part));
+    }
+    if (parts.size() != 4) {
+        throw std::invalid_argument("стоимости ходов — четыре числа через запятую: " + text);
+    }
+    return {parts[0], parts[1], parts[2], parts[3]};
+}
+
+#endif
@@ -2,54 +2,69 @@
 #define COMMON_FUNCTIONS_HPP
 
 #include "types.hpp"
+#include "state_store.hpp"
+#include "search_tree.hpp"
+#include "instrumentation.hpp"
+#include "search_workspace.hpp"
+#include <optional>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <string>
 
-inline auto generateNextStates(const State& current,
-                        int capacityA,
-                        int capacityB,
-                        std::vector<State>& nextStates) -> void {
-    int a = current.first;
-    int b = current.second;
-    nextStates.clear();
-    nextStates.emplace_back(capacityA, b);
-    nextStates.emplace_back(a, capacityB);
-    nextStates.emplace_back(0, b);
-    nextStates.emplace_back(a, 0);
-    
-    int transfer = std::min(a, capacityB - b);
-    nextStates.emplace_back(a - transfer, b + transfer);
-    
-    transfer = std::min(b, capacityA - a);
-    nextStates.emplace_back(a + transfer, b - transfer);
-
+// Стоимость пути в модели стоимости задачи: между соседними состояниями
+// берётся самый дешёвый ход. Считается после поиска, поэтому одинаково
+// подходит и алгоритмам, которые стоимость не отслеживают.
+template <typename Problem>
+inline auto pathCost(const Problem& problem, const std::vector<typename Problem::State>& path) -> long long {
+    long long total = 0;
+    for (size_t k = 1; k < path.size(); ++k) {
+        int best = std::numeric_limits<int>::max();
+        problem.forEachSuccessor(path[k - 1], [&](const typename Problem::State& next, int cost) {
+            if (next == path[k]) {
+                best = std::min(best, cost);
+            }
+        });
+        total += best;
+    }
+    return total;
 }
 
+template <typename Problem>
 inline std::tuple<bool, double, size_t, uint32_t> runAlgorithm(
-    AlgorithmFunction algo,
+    AlgorithmFunction<Problem> algo,
     const std::string& algoName,
-    const State& initial,
-    int capacityA,
-    int capacityB,
-    int targetVolume,
+    const Problem& problem,
+    const SearchOptions& options,
     bool log,
     bool silent = false
 ) {
-    Graph graph;
-    std::unordered_map<State, Graph::vertex_descriptor, StateHash> stateToVertex;
-    std::unordered_map<Graph::vertex_descriptor, State, VertexDescriptorHash> vertexToState;
+    // С рабочим пространством хранилище и арена сбрасываются, а не выделяются заново
+    std::optional<StateStore> ownStore;
+    if (options.workspace) {
+        options.workspace->reset();
+    }
+    StateStore& store = options.workspace ? options.workspace->store(problem.stateCount())
+                                          : ownStore.emplace(problem.stateCount());
 
-    Graph::vertex_descriptor startVertex = boost::add_vertex(graph);
-    stateToVertex[initial] = startVertex;
-    vertexToState[startVertex] = initial;
+    // Дерево перебора нужно только для выгрузки в graphviz
+    std::optional<SearchTree> tree;
+    SearchOptions runOptions = options;
+    if (log && !silent) {
+        runOptions.tree = &tree.emplace();
+    }
+
+    SearchStats stats;
+    if (kSearchInstrumentation && !silent && !runOptions.stats) {
+        runOptions.stats = &stats;
+    }
 
     auto startTime = std::chrono::high_resolution_clock::now();
     auto [pathFound, path, visitedNodes] = algo(
-        graph,
-        startVertex,
-        vertexToState,
-        stateToVertex,
-        capacityA,
-        capacityB,
-        targetVolume
+        problem,
+        store,
+        runOptions
     );
     auto endTime = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(endTime - startTime);
@@ -59,9 +74,14 @@ inline std::tuple<bool, double, size_t, uint32_t> runAlgorithm(
         if (pathFound) {
             std::cout << "Путь найден (" << std::fixed << std::setprecision(6) << time << " сек):" << std::endl;
             std::cout << "Длина пути: " << path.size() << std::endl;
+            std::cout << "Стоимость пути: " << pathCost(problem, path) << std::endl;
             std::cout << "Посещено узлов: " << visitedNodes << std::endl;
             std::cout << "Целенаправленность: " << std::fixed << std::setprecision(4) 
                       << static_cast<double>(path.size()) / visitedNodes << std::endl;
+            // Алгоритмы вне общего ядра поиска счетчики не заполняют
+            if (runOptions.stats == &stats && stats.expansions > 0) {
+                std::cout << "Статистика: " << stats << std::endl;
+            }
 
             if (log) {
                 std::string filename = algoName + "_search_tree.dot";
@@ -69,12 +89,13 @@ inline std::tuple<bool, double, size_t, uint32_t> runAlgorithm(
 
                 std::cout << "Путь: " << std::endl;
                 for (auto& e : path) {
-                    std::cout << "{"<< e.first << ", " << e.second << "}" << std::endl;
+                    problem.print(std::cout, e);
+                    std::cout << std::endl;
                 }
                 std::cout << std::endl;
 
                 if (dot_file.is_open()) {
-                    boost::write_graphviz(dot_file, graph, VertexWriter{vertexToState});
+                    writeSearchTree(dot_file, problem, *tree);
                     dot_file.close();
                     std::cout << "\nГраф дерева перебора сохранен в файл " << filename << std::endl;
                     std::cout << "Для визуализации выполните в терминале:" << std::endl;
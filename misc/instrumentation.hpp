@@ -0,0 +1,97 @@
+#ifndef INSTRUMENTATION_HPP
+#define INSTRUMENTATION_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+// Счетчики горячего цикла включаются флагом сборки SEARCH_INSTRUMENTATION
+// (опция CMake SEARCH_INSTRUMENTATION). Без него методы SearchProbe пусты,
+// и компилятор полностью убирает их вызовы.
+#ifndef SEARCH_INSTRUMENTATION
+#define SEARCH_INSTRUMENTATION 0
+#endif
+
+inline constexpr bool kSearchInstrumentation = SEARCH_INSTRUMENTATION != 0;
+
+struct SearchStats {
+    uint64_t expansions = 0;     // раскрытые вершины
+    uint64_t generated = 0;      // сгенерированные преемники
+    uint64_t duplicates = 0;     // преемники, уже бывшие в хранилище
+    uint64_t stalePops = 0;      // устаревшие записи, снятые с открытого списка
+    uint64_t peakOpenSize = 0;   // наибольший размер открытого списка
+    uint64_t probes = 0;         // обращения к хранилищу состояний
+    uint64_t bytesAllocated = 0; // хранилище, пик открытого списка и путь
+
+    double successorSeconds = 0;
+    double goalTestSeconds = 0;
+    double reconstructionSeconds = 0;
+};
+
+inline auto operator<<(std::ostream& out, const SearchStats& s) -> std::ostream& {
+    return out << "раскрыто " << s.expansions
+               << ", сгенерировано " << s.generated
+               << ", повторов " << s.duplicates
+               << ", устаревших " << s.stalePops
+               << ", пик открытого списка " << s.peakOpenSize
+               << ", обращений к хранилищу " << s.probes
+               << ", байт " << s.bytesAllocated
+               << "; время: преемники " << s.successorSeconds
+               << " сек, проверка цели " << s.goalTestSeconds
+               << " сек, восстановление пути " << s.reconstructionSeconds << " сек";
+}
+
+// Точка сбора статистики внутри алгоритма. Пишет в SearchStats, только
+// если инструментирование собрано и вызывающий передал куда писать.
+class SearchProbe {
+public:
+    using Counter = uint64_t SearchStats::*;
+    using Phase = double SearchStats::*;
+
+    explicit SearchProbe(SearchStats* stats) : stats_(stats) {}
+
+    auto enabled() const -> bool { return kSearchInstrumentation && stats_; }
+
+    void count(Counter counter, uint64_t n = 1) {
+        if constexpr (kSearchInstrumentation) {
+            if (stats_) {
+                stats_->*counter += n;
+            }
+        }
+    }
+
+    void observeMax(Counter counter, uint64_t value) {
+        if constexpr (kSearchInstrumentation) {
+            if (stats_) {
+                stats_->*counter = std::max(stats_->*counter, value);
+            }
+        }
+    }
+
+    // Замер фазы: время выполнения f прибавляется к полю phase.
+    template <typename F>
+    auto timed(Phase phase, F&& f) -> decltype(f()) {
+        if constexpr (kSearchInstrumentation) {
+            if (stats_) {
+                auto start = std::chrono::steady_clock::now();
+                struct Stop {
+                    SearchStats* stats;
+                    Phase phase;
+                    std::chrono::steady_clock::time_point start;
+                    ~Stop() {
+                        stats->*phase += std::chrono::duration<double>(
+                            std::chrono::steady_clock::now() - start).count();
+                    }
+                } stop{stats_, phase, start};
+                return f();
+            }
+        }
+        return f();
+    }
+
+private:
+    SearchStats* stats_;
+};
+
+#endif
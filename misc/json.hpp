@@ -0,0 +1,306 @@
+#ifndef JSON_HPP
+#define JSON_HPP
+
+#include <cctype>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// Минимальный JSON для построчного протокола сервера: разбор одного
+// значения (объекты, массивы, строки, числа, true/false/null) и
+// экранирование строк для ответа. Ответы собираются вручную, как и отчёты
+// бенчмарка.
+struct JsonValue {
+    using Array = std::vector<JsonValue>;
+    using Object = std::vector<std::pair<std::string, JsonValue>>;
+
+    std::variant<std::nullptr_t, bool, double, std::string, Array, Object> value = nullptr;
+
+    auto isNull() const -> bool { return std::holds_alternative<std::nullptr_t>(value); }
+    auto isBool() const -> bool { return std::holds_alternative<bool>(value); }
+    auto isNumber() const -> bool { return std::holds_alternative<double>(value); }
+    auto isString() const -> bool { return std::holds_alternative<std::string>(value); }
+    auto isArray() const -> bool { return std::holds_alternative<Array>(value); }
+    auto isObject() const -> bool { return std::holds_alternative<Object>(value); }
+
+    auto asBool() const -> bool { return std::get<bool>(value); }
+    auto asNumber() const -> double { return std::get<double>(value); }
+    auto asString() const -> const std::string& { return std::get<std::string>(value); }
+    auto asArray() const -> const Array& { return std::get<Array>(value); }
+    auto asObject() const -> const Object& { return std::get<Object>(value); }
+
+    // Целое число; дробные и слишком большие значения — ошибка. Диапазон
+    // проверяется до приведения: приведение вне диапазона int64_t — UB.
+    auto asInt() const -> int64_t {
+        constexpr double kLimit = 9223372036854775808.0; // 2^63
+        double number = asNumber();
+        if (!(number >= -kLimit && number < kLimit) || number != std::trunc(number)) {
+            throw std::invalid_argument("ожидалось целое число");
+        }
+        return static_cast<int64_t>(number);
+    }
+
+    // Поле объекта или nullptr, если его нет (или значение не объект).
+    auto find(std::string_view key) const -> const JsonValue* {
+        if (!isObject()) {
+            return nullptr;
+        }
+        for (const auto& [name, member] : asObject()) {
+            if (name == key) {
+                return &member;
+            }
+        }
+        return nullptr;
+    }
+};
+
+namespace json_detail {
+
+class Parser {
+public:
+    explicit Parser(std::string_view text) : text_(text) {}
+
+    auto parseDocument() -> JsonValue {
+        JsonValue value = parseValue(0);
+        skipSpace();
+        if (pos_ != text_.size()) {
+            fail("лишние символы после значения");
+        }
+        return value;
+    }
+
+private:
+    static constexpr int kMaxDepth = 64;
+
+    [[noreturn]] void fail(const std::string& message) const {
+        throw std::invalid_argument("JSON, позиция " + std::to_string(pos_) + ": " + message);
+    }
+
+    void skipSpace() {
+        while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) {
+            pos_++;
+        }
+    }
+
+    auto consume(char c) -> bool {
+        skipSpace();
+        if (pos_ < text_.size() && text_[pos_] == c) {
+            pos_++;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char c) {
+        if (!consume(c)) {
+            fail(std::string("ожидался символ '") + c + "'");
+        }
+    }
+
+    auto parseValue(int depth) -> JsonValue {
+        if (depth > kMaxDepth) {
+            fail("слишком глубокая вложенность");
+        }
+        skipSpace();
+        if (pos_ >= text_.size()) {
+            fail("неожиданный конец строки");
+        }
+        char c = text_[pos_];
+        if (c == '{') {
+            return parseObject(depth);
+        }
+        if (c == '[') {
+            return parseArray(depth);
+        }
+        if (c == '"') {
+            return {parseString()};
+        }
+        if (literal("true")) {
+            return {true};
+        }
+        if (literal("false")) {
+            return {false};
+        }
+        if (literal("null")) {
+            return {nullptr};
+        }
+        return {parseNumber()};
+    }
+
+    auto literal(std::string_view word) -> bool {
+        if (text_.substr(pos_, word.size()) == word) {
+            pos_ += word.size();
+            return true;
+        }
+        return false;
+    }
+
+    auto parseObject(int depth) -> JsonValue {
+        expect('{');
+        JsonValue::Object object;
+        if (consume('}')) {
+            return {std::move(object)};
+        }
+        do {
+            skipSpace();
+            if (pos_ >= text_.size() || text_[pos_] != '"') {
+                fail("ожидалось имя поля");
+            }
+            std::string key = parseString();
+            expect(':');
+            object.emplace_back(std::move(key), parseValue(depth + 1));
+        } while (consume(','));
+        expect('}');
+        return {std::move(object)};
+    }
+
+    auto parseArray(int depth) -> JsonValue {
+        expect('[');
+        JsonValue::Array array;
+        if (consume(']')) {
+            return {std::move(array)};
+        }
+        do {
+            array.push_back(parseValue(depth + 1));
+        } while (consume(','));
+        expect(']');
+        return {std::move(array)};
+    }
+
+    auto parseString() -> std::string {
+        pos_++; // открывающая кавычка
+        std::string out;
+        while (true) {
+            if (pos_ >= text_.size()) {
+                fail("незакрытая строка");
+            }
+            char c = text_[pos_++];
+            if (c == '"') {
+                return out;
+            }
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (pos_ >= text_.size()) {
+                fail("незакрытая строка");
+            }
+            char escaped = text_[pos_++];
+            switch (escaped) {
+            case '"': out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/': out += '/'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': appendCodePoint(out, parseHex4()); break;
+            default: fail("неизвестная escape-последовательность");
+            }
+        }
+    }
+
+    auto parseHex4() -> uint32_t {
+        if (pos_ + 4 > text_.size()) {
+            fail("неполная последовательность \\u");
+        }
+        uint32_t code = 0;
+        for (int i = 0; i < 4; ++i) {
+            char c = text_[pos_++];
+            code <<= 4;
+            if (c >= '0' && c <= '9') {
+                code |= static_cast<uint32_t>(c - '0');
+            } else if (c >= 'a' && c <= 'f') {
+                code |= static_cast<uint32_t>(c - 'a' + 10);
+            } else if (c >= 'A' && c <= 'F') {
+                code |= static_cast<uint32_t>(c - 'A' + 10);
+            } else {
+                fail("неверная последовательность \\u");
+            }
+        }
+        return code;
+    }
+
+    // Кодирование в UTF-8; суррогатные пары не склеиваются (только BMP).
+    static void appendCodePoint(std::string& out, uint32_t code) {
+        if (code < 0x80) {
+            out += static_cast<char>(code);
+        } else if (code < 0x800) {
+            out += static_cast<char>(0xC0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else {
+            out += static_cast<char>(0xE0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+
+    auto parseNumber() -> double {
+        size_t begin = pos_;
+        if (pos_ < text_.size() && text_[pos_] == '-') {
+            pos_++;
+        }
+        while (pos_ < text_.size()
+               && (std::isdigit(static_cast<unsigned char>(text_[pos_])) || text_[pos_] == '.'
+                   || text_[pos_] == 'e' || text_[pos_] == 'E' || text_[pos_] == '+' || text_[pos_] == '-')) {
+            pos_++;
+        }
+        if (begin == pos_) {
+            fail("ожидалось значение");
+        }
+        std::string number(text_.substr(begin, pos_ - begin));
+        size_t used = 0;
+        double value = 0;
+        try {
+            value = std::stod(number, &used);
+        } catch (const std::exception&) {
+            fail("неверное число " + number);
+        }
+        if (used != number.size()) {
+            fail("неверное число " + number);
+        }
+        return value;
+    }
+
+    std::string_view text_;
+    size_t pos_ = 0;
+};
+
+} // namespace json_detail
+
+inline auto parseJson(std::string_view text) -> JsonValue {
+    return json_detail::Parser(text).parseDocument();
+}
+
+// Строка в кавычках с экранированием для вывода в JSON.
+inline auto jsonQuote(std::string_view text) -> std::string {
+    std::string out = "\"";
+    for (char c : text) {
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                static constexpr char hex[] = "0123456789abcdef";
+                out += "\\u00";
+                out += hex[(c >> 4) & 0xF];
+                out += hex[c & 0xF];
+            } else {
+                out += c;
+            }
+        }
+    }
+    return out + "\"";
+}
+
+#endif
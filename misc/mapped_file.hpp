@@ -0,0 +1,75 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Файл, отображённый в память только для чтения. Страницы подгружаются
+// ядром по первому обращению, поэтому открытие большого файла почти
+// мгновенно, а несколько процессов делят одну копию в page cache.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("не удалось открыть " + path + ": " + std::strerror(errno));
+        }
+        struct stat info {};
+        if (::fstat(fd, &info) != 0) {
+            int error = errno;
+            ::close(fd);
+            throw std::runtime_error("не удалось прочитать размер " + path + ": " + std::strerror(error));
+        }
+        size_ = static_cast<size_t>(info.st_size);
+        if (size_ > 0) {
+            void* data = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+            if (data == MAP_FAILED) {
+                int error = errno;
+                ::close(fd);
+                throw std::runtime_error("не удалось отобразить " + path + ": " + std::strerror(error));
+            }
+            data_ = static_cast<const std::byte*>(data);
+        }
+        ::close(fd);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    auto operator=(const MappedFile&) -> MappedFile& = delete;
+
+    MappedFile(MappedFile&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {}
+
+    auto operator=(MappedFile&& other) noexcept -> MappedFile& {
+        if (this != &other) {
+            unmap();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+
+    ~MappedFile() { unmap(); }
+
+    auto data() const -> const std::byte* { return data_; }
+    auto size() const -> size_t { return size_; }
+
+private:
+    void unmap() {
+        if (data_) {
+            ::munmap(const_cast<std::byte*>(data_), size_);
+        }
+    }
+
+    const std::byte* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef SEARCH_TREE_HPP
+#define SEARCH_TREE_HPP
+
+#include "types.hpp"
+#include "state_store.hpp"
+#include <ostream>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Необязательный наблюдатель, записывающий дерево перебора компактным
+// списком рёбер над плотными индексами. Алгоритмы получают его через
+// SearchOptions::tree; без него поиск не тратит ни памяти, ни времени
+// на граф. Граф boost строится только при выгрузке в graphviz.
+struct SearchTree {
+    using Index = StateStore::Index;
+
+    std::vector<Index> roots;
+    std::vector<std::pair<Index, Index>> edges;
+
+    void addRoot(Index index) { roots.push_back(index); }
+    void addEdge(Index from, Index to) { edges.emplace_back(from, to); }
+};
+
+template <typename Problem>
+inline void writeSearchTree(std::ostream& out, const Problem& problem, const SearchTree& tree) {
+    Graph graph;
+    std::vector<SearchTree::Index> vertexToIndex;
+    std::unordered_map<SearchTree::Index, Graph::vertex_descriptor> indexToVertex;
+
+    auto vertexOf = [&](SearchTree::Index index) {
+        auto [it, inserted] = indexToVertex.try_emplace(index, 0);
+        if (inserted) {
+            it->second = boost::add_vertex(graph);
+            vertexToIndex.push_back(index);
+        }
+        return it->second;
+    };
+
+    for (SearchTree::Index root : tree.roots) {
+        vertexOf(root);
+    }
+    for (auto [from, to] : tree.edges) {
+        Graph::vertex_descriptor u = vertexOf(from);
+        boost::add_edge(u, vertexOf(to), graph);
+    }
+
+    boost::write_graphviz(out, graph, VertexWriter<Problem>{problem, vertexToIndex});
+}
+
+#endif
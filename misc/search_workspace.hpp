@@ -0,0 +1,103 @@
+#ifndef SEARCH_WORKSPACE_HPP
+#define SEARCH_WORKSPACE_HPP
+
+#include "types.hpp"
+#include "state_store.hpp"
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+// Рабочее пространство для серии поисков в одном потоке: хранилища
+// состояний и арена, из которой открытые списки и служебные буферы поиска
+// берут память. Между прогонами всё сбрасывается, а не освобождается:
+// хранилища — сдвигом смещения (StateStore::reset), арена — возвратом
+// к началу буфера. Если прогон не уместился в буфер, при сбросе буфер
+// вырастает до достигнутого объёма, и следующие прогоны той же величины
+// обходятся без обращений к системному аллокатору.
+//
+// Память арены не освобождается до сброса, поэтому путь в SearchResult
+// по-прежнему обычный вектор: он переживает сброс. Пространство не
+// потокобезопасно — по одному на поток.
+class SearchWorkspace {
+public:
+    explicit SearchWorkspace(size_t arenaBytes = size_t{1} << 20) { allocateArena(arenaBytes); }
+
+    SearchWorkspace(const SearchWorkspace&) = delete;
+    auto operator=(const SearchWorkspace&) -> SearchWorkspace& = delete;
+
+    // Все контейнеры, взятые из арены, к этому моменту должны быть уничтожены.
+    void reset() {
+        size_t overflow = upstream_.bytes();
+        arena_->release();
+        if (overflow > 0) {
+            allocateArena(arenaBytes_ + overflow);
+        }
+    }
+
+    auto resource() -> std::pmr::memory_resource* { return &*arena_; }
+
+    // Пустое хранилище не меньше чем на stateCount состояний: прежнее
+    // сбрасывается за O(1), новое выделяется, только если прежнее мало.
+    auto store(size_t stateCount) -> StateStore& { return prepare(primary_, stateCount); }
+
+    // Второе хранилище — для обратного фронта двунаправленного поиска.
+    auto auxiliaryStore(size_t stateCount) -> StateStore& { return prepare(auxiliary_, stateCount); }
+
+    auto arenaBytes() const -> size_t { return arenaBytes_; }
+
+private:
+    // Верхний ресурс арены: запоминает, сколько не поместилось в буфер.
+    class CountingResource : public std::pmr::memory_resource {
+    public:
+        auto bytes() const -> size_t { return bytes_; }
+        void clear() { bytes_ = 0; }
+
+    private:
+        auto do_allocate(size_t bytes, size_t alignment) -> void* override {
+            bytes_ += bytes;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+        auto do_is_equal(const std::pmr::memory_resource& other) const noexcept -> bool override {
+            return this == &other;
+        }
+
+        size_t bytes_ = 0;
+    };
+
+    void allocateArena(size_t bytes) {
+        arena_.reset();
+        upstream_.clear();
+        arenaBytes_ = bytes;
+        buffer_ = std::make_unique_for_overwrite<std::byte[]>(bytes);
+        arena_.emplace(buffer_.get(), bytes, &upstream_);
+    }
+
+    static auto prepare(std::optional<StateStore>& store, size_t stateCount) -> StateStore& {
+        if (store && store->size() >= stateCount) {
+            store->reset();
+        } else {
+            store.reset();
+            store.emplace(stateCount);
+        }
+        return *store;
+    }
+
+    CountingResource upstream_;
+    std::unique_ptr<std::byte[]> buffer_;
+    size_t arenaBytes_ = 0;
+    std::optional<std::pmr::monotonic_buffer_resource> arena_;
+    std::optional<StateStore> primary_;
+    std::optional<StateStore> auxiliary_;
+};
+
+// Ресурс памяти для контейнеров поиска: арена рабочего пространства,
+// если оно передано, иначе обычный new/delete.
+inline auto searchResource(const SearchOptions& options) -> std::pmr::memory_resource* {
+    return options.workspace ? options.workspace->resource() : std::pmr::get_default_resource();
+}
+
+#endif
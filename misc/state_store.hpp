@@ -0,0 +1,104 @@
+#ifndef STATE_STORE_HPP
+#define STATE_STORE_HPP
+
+#include "types.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+// Массив тривиальных элементов, обнулённый через calloc. Большие блоки calloc
+// берёт у ядра уже нулевыми страницами, которые физически выделяются только
+// при первом касании, поэтому сетка (A+1)x(B+1), где поиск посещает лишь
+// малую часть ячеек, не требует memset на весь объём.
+template <typename T>
+class ZeroedArray {
+    static_assert(std::is_trivial_v<T>, "ZeroedArray хранит только тривиальные типы");
+
+    struct Free {
+        void operator()(T* p) const { std::free(p); }
+    };
+
+public:
+    explicit ZeroedArray(size_t size)
+        : data_(static_cast<T*>(std::calloc(size ? size : 1, sizeof(T)))),
+          size_(size) {
+        if (!data_) {
+            throw std::bad_alloc();
+        }
+    }
+
+    auto size() const -> size_t { return size_; }
+    void clear() { std::memset(static_cast<void*>(data_.get()), 0, size_ * sizeof(T)); }
+    auto operator[](size_t i) -> T& { return data_[i]; }
+    auto operator[](size_t i) const -> const T& { return data_[i]; }
+
+private:
+    std::unique_ptr<T[], Free> data_;
+    size_t size_;
+};
+
+// Плотное хранилище вершин поиска. Задача отображает состояние в индекс
+// из [0, stateCount), а родитель и стоимость лежат рядом в одном непрерывном
+// массиве узлов: никакого хеширования и аллокаций на узел.
+class StateStore {
+public:
+    using Index = uint32_t;
+
+    explicit StateStore(size_t stateCount) : nodes_(stateCount) {}
+
+    auto size() const -> size_t { return nodes_.size(); }
+    auto memoryBytes() const -> size_t { return nodes_.size() * sizeof(Node); }
+
+    // Поле parent хранит base_ + индекс родителя + 1; значения не больше
+    // base_ означают «не обнаружено», корень ссылается сам на себя.
+    auto isDiscovered(Index i) const -> bool { return nodes_[i].parent > base_; }
+    auto isRoot(Index i) const -> bool { return nodes_[i].parent == base_ + i + 1; }
+    auto parentOf(Index i) const -> Index { return nodes_[i].parent - base_ - 1; }
+    auto costOf(Index i) const -> int { return nodes_[i].cost; }
+
+    void setRoot(Index i) { nodes_[i] = {base_ + i + 1, 0}; }
+    void setParent(Index i, Index parent, int cost) { nodes_[i] = {base_ + parent + 1, cost}; }
+
+    // Сброс для повторного поиска за O(1): смещение base_ сдвигается за все
+    // записанные значения, и прежние узлы становятся необнаруженными. Массив
+    // обнуляется целиком, только когда смещение подходит к пределу 32 бит.
+    void reset() {
+        uint64_t span = uint64_t{nodes_.size()} + 1;
+        if (uint64_t{base_} + 2 * span > UINT32_MAX) {
+            nodes_.clear();
+            base_ = 0;
+        } else {
+            base_ += static_cast<Index>(span);
+        }
+    }
+
+    template <typename Problem>
+    auto pathTo(const Problem& problem, Index target) const -> std::vector<typename Problem::State> {
+        std::vector<typename Problem::State> path;
+        Index current = target;
+        path.push_back(problem.stateOf(current));
+        while (!isRoot(current)) {
+            current = parentOf(current);
+            path.push_back(problem.stateOf(current));
+        }
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+private:
+    struct Node {
+        Index parent;
+        int cost;
+    };
+
+    ZeroedArray<Node> nodes_;
+    Index base_ = 0;
+};
+
+#endif
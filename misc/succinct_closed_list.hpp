@@ -0,0 +1,70 @@
+#ifndef SUCCINCT_CLOSED_LIST_HPP
+#define SUCCINCT_CLOSED_LIST_HPP
+
+#include "state_store.hpp"
+#include <bit>
+#include <cstdint>
+
+// Компактный закрытый список для поиска в ширину над плотным индексом:
+// бит «посещено» и упакованный код на состояние вместо 8-байтового узла
+// StateStore. Код — номер хода, которым состояние обнаружено (0 у корня),
+// и глубина по модулю 3. Для двух сосудов это 1 + 5 бит, для трёх и
+// четырёх — 1 + 6 и 1 + 7 бит, то есть меньше байта на состояние.
+//
+// Ходы задачи о сосудах необратимы: наполнение, опустошение и переливание
+// забывают прежние объёмы, и по коду хода родитель однозначно не
+// восстанавливается. Поэтому путь восстанавливает succinctBfs обратным
+// поиском по предшественникам, согласованным с кодами.
+class SuccinctClosedList {
+public:
+    using Index = StateStore::Index;
+
+    SuccinctClosedList(size_t stateCount, int moveCount)
+        : width_(std::bit_width(static_cast<unsigned>(moveCount)) + 2),
+          visited_((stateCount + 63) / 64),
+          codes_((stateCount * width_ + 63) / 64 + 1) {}
+
+    auto memoryBytes() const -> size_t { return (visited_.size() + codes_.size()) * sizeof(uint64_t); }
+    auto bitsPerState() const -> unsigned { return 1 + width_; }
+
+    auto isVisited(Index i) const -> bool { return visited_[i >> 6] >> (i & 63) & 1; }
+    auto visitedWords() const -> const uint64_t* { return &visited_[0]; }
+    auto isRoot(Index i) const -> bool { return isVisited(i) && moveOf(i) < 0; }
+
+    // Номер хода, которым обнаружено состояние; -1 у корня.
+    auto moveOf(Index i) const -> int { return static_cast<int>(code(i) >> 2) - 1; }
+    auto depthMod3(Index i) const -> int { return static_cast<int>(code(i) & 3); }
+
+    void setRoot(Index i) { mark(i, -1, 0); }
+
+    // Каждое состояние отмечается один раз: слот кода до этого нулевой.
+    void mark(Index i, int move, int depth) {
+        visited_[i >> 6] |= uint64_t{1} << (i & 63);
+        uint64_t value = static_cast<uint64_t>(move + 1) << 2 | static_cast<uint64_t>(depth % 3);
+        size_t bit = size_t{i} * width_;
+        size_t word = bit >> 6;
+        unsigned offset = bit & 63;
+        codes_[word] |= value << offset;
+        if (offset + width_ > 64) {
+            codes_[word + 1] |= value >> (64 - offset);
+        }
+    }
+
+private:
+    auto code(Index i) const -> uint64_t {
+        size_t bit = size_t{i} * width_;
+        size_t word = bit >> 6;
+        unsigned offset = bit & 63;
+        uint64_t value = codes_[word] >> offset;
+        if (offset + width_ > 64) {
+            value |= codes_[word + 1] << (64 - offset);
+        }
+        return value & ((uint64_t{1} << width_) - 1);
+    }
+
+    unsigned width_;
+    ZeroedArray<uint64_t> visited_;
+    ZeroedArray<uint64_t> codes_;
+};
+
+#endif
@@ -3,49 +3,75 @@
 
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/breadth_first_search.hpp>
-#include <boost/functional/hash.hpp>
 #include <boost/graph/graphviz.hpp>
+#include <cstdint>
 #include <iostream>
-#include <unordered_map>
-#include <utility>
+#include <stop_token>
+#include <string>
+#include <vector>
 
-using State = std::pair<int, int>;
 using Graph = boost::adjacency_list<boost::vecS, boost::vecS, boost::directedS>;
 
-struct StateHash {
-    size_t operator()(const State& p) const {
-        size_t seed = 0;
-        boost::hash_combine(seed, p.first);
-        boost::hash_combine(seed, p.second);
-        return seed;
-    }
+class StateStore;
+struct SearchTree;
+struct SearchStats;
+class PatternDatabase;
+class SolutionCache;
+class SearchWorkspace;
+
+template <typename State>
+struct SearchResult {
+    bool pathFound = false;
+    std::vector<State> path;
+    uint32_t visitedNodes = 0;
 };
 
-struct VertexDescriptorHash {
-    size_t operator()(const Graph::vertex_descriptor& v) const {
-        return std::hash<Graph::vertex_descriptor>()(v);
-    }
+// Параметры запуска, общие для всех алгоритмов. Алгоритм читает только
+// то, что ему нужно.
+struct SearchOptions {
+    unsigned threads = 0;        // 0 — все доступные ядра
+    SearchTree* tree = nullptr;  // запись дерева перебора, если нужна
+    SearchStats* stats = nullptr; // счетчики, если собрано с SEARCH_INSTRUMENTATION
+    const PatternDatabase* patterns = nullptr; // база шаблонов для A*, если загружена
+    size_t transpositionEntries = size_t{1} << 16; // таблица транспозиций IDA*/IDDFS, 0 — без нее
+    size_t externalBufferBytes = size_t{64} << 20;  // буфер внешнего BFS
+    std::string externalDirectory;                  // каталог его файлов, пусто — системный tmp
+    SolutionCache* cache = nullptr;                 // постоянный кэш решений, если подключен
+    SearchWorkspace* workspace = nullptr;           // повторно используемая память серии поисков
+    std::stop_token stop;                           // кооперативная отмена, см. stopRequested
 };
 
+// Поиски опрашивают SearchOptions::stop раз в kStopCheckInterval раскрытых
+// вершин и по запросу останавливаются с результатом «путь не найден».
+inline constexpr uint32_t kStopCheckInterval = 1024;
+
+inline auto stopRequested(const SearchOptions& options, uint32_t expanded) -> bool {
+    return expanded % kStopCheckInterval == 0 && options.stop.stop_requested();
+}
+
+// Точка входа алгоритма для выбора во время выполнения. Сам поиск внутри
+// конкретной инстанциации полностью специализирован под задачу.
+template <typename Problem>
+using AlgorithmFunction = SearchResult<typename Problem::State> (*)(
+    const Problem&,
+    StateStore&,
+    const SearchOptions&
+);
+
+template <typename Problem>
 struct VertexWriter {
-    const std::unordered_map<Graph::vertex_descriptor, State, VertexDescriptorHash>& vertexToState;
+    const Problem& problem;
+    const std::vector<uint32_t>& vertexToIndex;
     template <typename Vertex>
     void operator()(std::ostream& out, const Vertex& v) const {
-        auto it = vertexToState.find(v);
-        if (it != vertexToState.end()) {
-            out << "[label=\"(" << it->second.first << "," << it->second.second << ")\"]";
+        if (v < vertexToIndex.size()) {
+            out << "[label=\"";
+            problem.print(out, problem.stateOf(vertexToIndex[v]));
+            out << "\"]";
         } else {
             out << "[label=\"?\"]";
         }
     }
 };
 
-using AlgorithmFunction = std::tuple<bool, std::vector<State>, uint32_t> (*)(
-    Graph&,
-    Graph::vertex_descriptor,
-    std::unordered_map<Graph::vertex_descriptor, State, VertexDescriptorHash>&,
-    std::unordered_map<State, Graph::vertex_descriptor, StateHash>&,
-    int, int, int
-);
-
 #endif
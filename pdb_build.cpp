@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "problems/jugs.hpp"
+#include "misc/cli_utils.hpp"
+#include "searches/pattern_database.hpp"
+
+// Строит базу шаблонов для A* (searches/pattern_database.hpp) под одну
+// конфигурацию сосудов и модель стоимости. Готовый файл передается в main
+// или benchmark (--pdb) и переиспользуется для всех целей из набора.
+
+namespace {
+
+struct BuildConfig {
+    std::vector<int> capacities;
+    std::vector<uint64_t> patterns;
+    std::vector<int> targets;
+    MoveCosts costs;
+    std::string output;
+};
+
+void printUsage() {
+    std::cerr <<
+        "Использование: pdb_build --capacities \"A B C ...\" --output FILE [опции]\n"
+        "  --capacities \"A B ...\"         емкости сосудов\n"
+        "  --patterns \"0,1 1,2 ...\"       шаблоны — номера сосудов через запятую\n"
+        "                                 (по умолчанию все пары сосудов)\n"
+        "  --targets lo:hi[:step]         цели, для которых строится база\n"
+        "                                 (по умолчанию 0:наибольшая емкость)\n"
+        "  --costs F,E,P,L                стоимость наполнения, опустошения, переливания\n"
+        "                                 и каждого литра (1,1,1,0)\n"
+        "  --output FILE                  файл базы\n";
+}
+
+auto parsePatterns(const std::string& text) -> std::vector<uint64_t> {
+    std::vector<uint64_t> patterns;
+    std::istringstream in(text);
+    for (std::string token; in >> token;) {
+        uint64_t mask = 0;
+        std::istringstream jugs(token);
+        for (std::string jug; std::getline(jugs, jug, ',');) {
+            int index = std::stoi(jug);
+            if (index < 0 || index >= 64) {
+                throw std::invalid_argument("неверный номер сосуда: " + jug);
+            }
+            mask |= uint64_t{1} << index;
+        }
+        patterns.push_back(mask);
+    }
+    return patterns;
+}
+
+// Все пары сосудов; для одного сосуда — он сам. Для двух сосудов
+// единственная пара совпадает с исходной задачей, и оценка точна.
+auto defaultPatterns(size_t jugs) -> std::vector<uint64_t> {
+    if (jugs == 1) {
+        return {1};
+    }
+    std::vector<uint64_t> patterns;
+    for (size_t i = 0; i < jugs; ++i) {
+        for (size_t j = i + 1; j < jugs; ++j) {
+            patterns.push_back(uint64_t{1} << i | uint64_t{1} << j);
+        }
+    }
+    return patterns;
+}
+
+auto parseArguments(int argc, char** argv) -> BuildConfig {
+    BuildConfig config;
+    auto value = [&](int& i) -> std::string {
+        if (i + 1 >= argc) {
+            throw std::invalid_argument(std::string("нет значения для ") + argv[i]);
+        }
+        return argv[++i];
+    };
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--capacities") {
+            std::istringstream in(value(i));
+            for (int capacity; in >> capacity;) {
+                config.capacities.push_back(capacity);
+            }
+        } else if (arg == "--patterns") {
+            config.patterns = parsePatterns(value(i));
+        } else if (arg == "--targets") {
+            config.targets = parseRange(value(i));
+        } else if (arg == "--costs") {
+            config.costs = parseCosts(value(i));
+        } else if (arg == "--output") {
+            config.output = value(i);
+        } else if (arg == "--help" || arg == "-h") {
+            printUsage();
+            std::exit(0);
+        } else {
+            throw std::invalid_argument("неизвестный параметр: " + arg);
+        }
+    }
+
+    if (config.capacities.empty() || config.output.empty()) {
+        throw std::invalid_argument("нужны --capacities и --output");
+    }
+    if (config.patterns.empty()) {
+        config.patterns = defaultPatterns(config.capacities.size());
+    }
+    if (config.targets.empty()) {
+        config.targets = parseRange("0:" + std::to_string(*std::max_element(config.capacities.begin(),
+                                                                            config.capacities.end())));
+    }
+    return config;
+}
+
+} // namespace
+
+auto main(int argc, char** argv) -> int {
+    BuildConfig config;
+    try {
+        config = parseArguments(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка: " << e.what() << "\n";
+        printUsage();
+        return 1;
+    }
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    try {
+        std::ofstream file(config.output, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("не удалось создать файл " + config.output);
+        }
+        buildPatternDatabase(file, config.capacities, config.costs, config.patterns, config.targets);
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка: " << e.what() << "\n";
+        std::remove(config.output.c_str());
+        return 1;
+    }
+    auto endTime = std::chrono::high_resolution_clock::now();
+
+    PatternDatabase database(config.output);
+    std::cout << "База шаблонов " << config.output << ": шаблонов " << database.patternCount()
+              << ", целей " << database.targets().size()
+              << ", построена за " << std::chrono::duration<double>(endTime - startTime).count()
+              << " сек" << std::endl;
+    return 0;
+}
@@ -0,0 +1,428 @@
+#ifndef JUGS_HPP
+#define JUGS_HPP
+
+#include "jugs_batch.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Состояние N сосудов, упакованное в одно 64-битное слово: объём сосуда i
+// занимает width_i = bit_width(capacity_i) бит начиная со смещения shift_i.
+// Сравнение и хеширование — операции над одним словом.
+struct PackedState {
+    uint64_t word = 0;
+
+    friend auto operator==(PackedState a, PackedState b) -> bool = default;
+};
+
+template <>
+struct std::hash<PackedState> {
+    auto operator()(PackedState s) const noexcept -> size_t {
+        // Финализатор splitmix64: одно умножение-перемешивание на слово.
+        uint64_t x = s.word;
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return static_cast<size_t>(x);
+    }
+};
+
+// Модель стоимости хода: фиксированная цена по типу хода плюс perLiter за
+// каждый перемещённый литр (набранный из крана, вылитый или перелитый).
+// По умолчанию каждый ход стоит 1; {0, 0, 0, 1} — минимизация объёма воды.
+struct MoveCosts {
+    int fill = 1;
+    int empty = 1;
+    int pour = 1;
+    int perLiter = 0;
+
+    auto isUnit() const -> bool { return fill == 1 && empty == 1 && pour == 1 && perLiter == 0; }
+};
+
+// Задача о N сосудах: из состояния «первый сосуд полон, остальные пусты»
+// получить ровно targetVolume литров в любом из сосудов. Ходы: наполнить
+// сосуд, вылить сосуд, перелить из сосуда i в сосуд j для каждой
+// упорядоченной пары. Стоимость хода задаёт MoveCosts.
+class JugsProblem {
+public:
+    using State = PackedState;
+    using Index = uint32_t;
+    using BatchSuccessor = ::BatchSuccessor;
+
+    JugsProblem(std::vector<int> capacities, int targetVolume, MoveCosts costs = {})
+        : capacities_(std::move(capacities)), targetVolume_(targetVolume), costs_(costs) {
+        if (capacities_.empty()) {
+            throw std::invalid_argument("нужен хотя бы один сосуд");
+        }
+        if (costs_.fill < 0 || costs_.empty < 0 || costs_.pour < 0 || costs_.perLiter < 0) {
+            throw std::invalid_argument("стоимости ходов должны быть неотрицательными");
+        }
+
+        size_t jugs = capacities_.size();
+        shifts_.resize(jugs);
+        masks_.resize(jugs);
+        strides_.resize(jugs);
+
+        unsigned shift = 0;
+        for (size_t i = 0; i < jugs; ++i) {
+            if (capacities_[i] < 0) {
+                throw std::invalid_argument("емкости сосудов должны быть неотрицательными");
+            }
+            unsigned width = std::bit_width(static_cast<unsigned>(capacities_[i]));
+            if (shift + width > 64) {
+                throw std::length_error("состояние не помещается в 64-битное слово");
+            }
+            shifts_[i] = shift;
+            masks_[i] = width == 64 ? ~0ULL : (1ULL << width) - 1;
+            shift += width;
+        }
+
+        // Самый дорогой ход перемещает не больше наибольшей ёмкости
+        int64_t maxCapacity = *std::max_element(capacities_.begin(), capacities_.end());
+        int64_t maxStepCost = std::max({costs_.fill, costs_.empty, costs_.pour}) + int64_t{costs_.perLiter} * maxCapacity;
+        if (maxStepCost > std::numeric_limits<int>::max()) {
+            throw std::overflow_error("стоимость хода не помещается в int");
+        }
+
+        // Плотная нумерация в смешанной системе счисления, последний сосуд
+        // младший разряд: для двух сосудов индекс равен a*(B+1)+b.
+        stateCount_ = 1;
+        for (size_t i = jugs; i-- > 0;) {
+            strides_[i] = stateCount_;
+            stateCount_ *= static_cast<size_t>(capacities_[i]) + 1;
+            if (stateCount_ >= UINT32_MAX) {
+                throw std::length_error("пространство состояний не помещается в 32-битный индекс");
+            }
+        }
+
+        if (jugs <= kMaxBatchJugs) {
+            batchLayout_.jugs = jugs;
+            for (size_t i = 0; i < jugs; ++i) {
+                batchLayout_.capacity[i] = static_cast<uint32_t>(capacities_[i]);
+                batchLayout_.stride[i] = static_cast<uint32_t>(strides_[i]);
+            }
+        }
+        setBatchIsa(detectBatchIsa());
+    }
+
+    auto jugCount() const -> size_t { return capacities_.size(); }
+    auto capacities() const -> const std::vector<int>& { return capacities_; }
+    auto capacity(size_t jug) const -> int { return capacities_[jug]; }
+    auto targetVolume() const -> int { return targetVolume_; }
+    auto costs() const -> const MoveCosts& { return costs_; }
+
+    auto volume(State s, size_t jug) const -> int {
+        return static_cast<int>((s.word >> shifts_[jug]) & masks_[jug]);
+    }
+
+    auto withVolume(State s, size_t jug, int volume) const -> State {
+        uint64_t cleared = s.word & ~(masks_[jug] << shifts_[jug]);
+        return {cleared | (static_cast<uint64_t>(volume) << shifts_[jug])};
+    }
+
+    auto makeState(const std::vector<int>& volumes) const -> State {
+        State s;
+        for (size_t i = 0; i < jugCount(); ++i) {
+            s = withVolume(s, i, volumes[i]);
+        }
+        return s;
+    }
+
+    // Объём измерим тогда и только тогда, когда он не больше наибольшей
+    // емкости и кратен НОД всех емкостей: любой ход сохраняет кратность НОД.
+    auto isSolvable() const -> bool {
+        if (targetVolume_ < 0) {
+            return false;
+        }
+        int divisor = 0;
+        for (int capacity : capacities_) {
+            divisor = std::gcd(divisor, capacity);
+        }
+        if (targetVolume_ > *std::max_element(capacities_.begin(), capacities_.end())) {
+            return false;
+        }
+        return divisor == 0 ? targetVolume_ == 0 : targetVolume_ % divisor == 0;
+    }
+
+    auto initial() const -> State { return withVolume(State{}, 0, capacities_[0]); }
+
+    auto isGoal(State s) const -> bool {
+        for (size_t i = 0; i < jugCount(); ++i) {
+            if (volume(s, i) == targetVolume_) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Ходы пронумерованы: наполнения 0..N-1, опустошения N..2N-1, затем
+    // переливания по парам (i, j) в лексикографическом порядке. Для двух
+    // сосудов порядок совпадает с исходными шестью ходами.
+    auto moveCount() const -> int {
+        int jugs = static_cast<int>(jugCount());
+        return jugs * (jugs + 1);
+    }
+
+    template <typename Visit>
+    void forEachSuccessor(State current, Visit&& visit) const {
+        forEachMove(current, [&](State next, int cost, int) { visit(next, cost); });
+    }
+
+    // Преемники вместе с номером хода. Пустые ходы — наполнить полный сосуд,
+    // вылить пустой, перелить ноль литров — не выдаются: они возвращают в то
+    // же состояние. Остальные ходы одного состояния дают попарно различные
+    // преемники, так что повторов среди выданных нет.
+    template <typename Visit>
+    void forEachMove(State current, Visit&& visit) const {
+        size_t jugs = jugCount();
+        int move = 0;
+        for (size_t i = 0; i < jugs; ++i, ++move) {
+            int added = capacities_[i] - volume(current, i);
+            if (added > 0) {
+                visit(withVolume(current, i, capacities_[i]), fillCost(added), move);
+            }
+        }
+        for (size_t i = 0; i < jugs; ++i, ++move) {
+            int removed = volume(current, i);
+            if (removed > 0) {
+                visit(withVolume(current, i, 0), emptyCost(removed), move);
+            }
+        }
+        for (size_t i = 0; i < jugs; ++i) {
+            int from = volume(current, i);
+            for (size_t j = 0; j < jugs; ++j) {
+                if (i == j) {
+                    continue;
+                }
+                int to = volume(current, j);
+                int transfer = std::min(from, capacities_[j] - to);
+                if (transfer > 0) {
+                    visit(withVolume(withVolume(current, i, from - transfer), j, to + transfer),
+                          pourCost(transfer), move);
+                }
+                move++;
+            }
+        }
+    }
+
+    // Обратные ходы для поиска от целей: все состояния p != s, из которых
+    // один прямой ход ведёт в s.
+    template <typename Visit>
+    void forEachPredecessor(State current, Visit&& visit) const {
+        for (int move = 0; move < moveCount(); ++move) {
+            forEachInverse(current, move, visit);
+        }
+    }
+
+    // Состояния p != s, из которых ход move ведёт в s. Наполнить/вылить
+    // сосуд i могло любое состояние с иным объёмом в i; переливание i -> j
+    // заканчивается пустым источником или полным приёмником, и в этих
+    // случаях перебирается перелитый объём t.
+    template <typename Visit>
+    void forEachInverse(State current, int move, Visit&& visit) const {
+        size_t jugs = jugCount();
+        size_t m = static_cast<size_t>(move);
+        if (m < jugs) {
+            size_t i = m;
+            if (volume(current, i) == capacities_[i]) {
+                for (int x = 0; x < capacities_[i]; ++x) {
+                    visit(withVolume(current, i, x), fillCost(capacities_[i] - x));
+                }
+            }
+            return;
+        }
+        if (m < 2 * jugs) {
+            size_t i = m - jugs;
+            if (volume(current, i) == 0) {
+                for (int x = 1; x <= capacities_[i]; ++x) {
+                    visit(withVolume(current, i, x), emptyCost(x));
+                }
+            }
+            return;
+        }
+        size_t pair = m - 2 * jugs;
+        size_t i = pair / (jugs - 1);
+        size_t j = pair % (jugs - 1);
+        j += j >= i ? 1 : 0;
+        int from = volume(current, i);
+        int to = volume(current, j);
+        if (from == 0) {
+            for (int t = 1; t <= std::min(to, capacities_[i]); ++t) {
+                visit(withVolume(withVolume(current, i, t), j, to - t), pourCost(t));
+            }
+        } else if (to == capacities_[j]) {
+            for (int t = 1; t <= std::min(to, capacities_[i] - from); ++t) {
+                visit(withVolume(withVolume(current, i, from + t), j, to - t), pourCost(t));
+            }
+        }
+    }
+
+    // Все целевые состояния, каждое ровно один раз: сосуд i содержит
+    // targetVolume, а сосуды с меньшими номерами — нет.
+    template <typename Visit>
+    void forEachGoal(Visit&& visit) const {
+        size_t jugs = jugCount();
+        std::vector<int> volumes(jugs, 0);
+        for (size_t i = 0; i < jugs; ++i) {
+            if (targetVolume_ < 0 || targetVolume_ > capacities_[i]) {
+                continue;
+            }
+            std::fill(volumes.begin(), volumes.end(), 0);
+            volumes[i] = targetVolume_;
+            while (true) {
+                bool earlierHit = false;
+                for (size_t j = 0; j < i; ++j) {
+                    earlierHit = earlierHit || volumes[j] == targetVolume_;
+                }
+                if (!earlierHit) {
+                    visit(makeState(volumes));
+                }
+
+                size_t k = jugs;
+                while (k-- > 0) {
+                    if (k == i) {
+                        continue;
+                    }
+                    if (volumes[k] < capacities_[k]) {
+                        volumes[k]++;
+                        break;
+                    }
+                    volumes[k] = 0;
+                }
+                if (k == static_cast<size_t>(-1)) {
+                    break;
+                }
+            }
+        }
+    }
+
+    // Семейство допустимых и монотонных оценок для любой MoveCosts; член
+    // семейства — глубина просмотра вперёд k (setHeuristicLookahead).
+    //
+    // h_0: пока ни в одном сосуде нет targetVolume, нужен ещё хотя бы один
+    // ход (не дешевле самой дешёвой фиксированной цены), а объём сосуда i
+    // должен измениться на |v_i - t| литров. Ход меняет объём любого сосуда
+    // не больше, чем на перемещённые им литры, поэтому h_0 монотонна.
+    //
+    // h_k(s) — минимум c(s, s') + h_{k-1}(s') по ходам из s. Для монотонной
+    // h_0 последовательность не убывает по k, и каждый её член монотонен:
+    // h_k(s) <= c + h_{k-1}(s') <= c + h_k(s'). При единичных стоимостях
+    // h_k = min(k + 1, число ходов до цели). Вызов стоит (N(N+1))^k
+    // генераций. Глубина 1 (по умолчанию) на случайных задачах из трёх
+    // сосудов раскрывает в A* примерно на 30% меньше вершин, чем UCS, при
+    // единичных стоимостях и на 10% меньше при стоимостях с литрами; у двух
+    // сосудов граф почти цепочка, и выигрыша нет. Глубже вершин меньше, но
+    // время растёт быстрее, чем их убывает.
+    auto heuristic(State s) const -> int { return lookahead(s, heuristicLookahead_); }
+
+    static constexpr int kMaxHeuristicLookahead = 3;
+
+    void setHeuristicLookahead(int depth) {
+        if (depth < 0 || depth > kMaxHeuristicLookahead) {
+            throw std::invalid_argument("глубина просмотра эвристики — от 0 до "
+                                        + std::to_string(kMaxHeuristicLookahead));
+        }
+        heuristicLookahead_ = depth;
+    }
+    auto heuristicLookahead() const -> int { return heuristicLookahead_; }
+
+    auto stateCount() const -> size_t { return stateCount_; }
+
+    auto indexOf(State s) const -> Index {
+        size_t index = 0;
+        for (size_t i = 0; i < jugCount(); ++i) {
+            index += static_cast<size_t>(volume(s, i)) * strides_[i];
+        }
+        return static_cast<Index>(index);
+    }
+
+    auto stateOf(Index index) const -> State {
+        State s;
+        for (size_t i = 0; i < jugCount(); ++i) {
+            s = withVolume(s, i, static_cast<int>(index / strides_[i]));
+            index %= strides_[i];
+        }
+        return s;
+    }
+
+    // Пакетное раскрытие блока индексов с отсевом по битовому множеству
+    // посещённых (problems/jugs_batch.hpp). Преемники — в порядке forEachMove.
+    auto canExpandBatch() const -> bool { return batchLayout_.jugs == jugCount(); }
+
+    auto expandBatch(const Index* indices, size_t count, const uint64_t* visited, BatchSuccessor* out) const
+        -> size_t {
+        return batchKernel_(batchLayout_, indices, count, visited, out);
+    }
+
+    // По умолчанию — лучший набор инструкций процессора; другой — для сравнения.
+    void setBatchIsa(BatchIsa isa) {
+        batchIsa_ = isa;
+        batchKernel_ = batchKernel(isa);
+    }
+    auto batchIsa() const -> BatchIsa { return batchIsa_; }
+
+    void print(std::ostream& out, State s) const {
+        out << "{";
+        for (size_t i = 0; i < jugCount(); ++i) {
+            out << (i ? ", " : "") << volume(s, i);
+        }
+        out << "}";
+    }
+
+private:
+    auto baseHeuristic(State s) const -> int {
+        int best = std::numeric_limits<int>::max();
+        for (size_t i = 0; i < jugCount(); ++i) {
+            int distance = std::abs(volume(s, i) - targetVolume_);
+            if (distance == 0) {
+                return 0;
+            }
+            best = std::min(best, distance);
+        }
+        int cheapestMove = std::min({costs_.fill, costs_.empty, costs_.pour});
+        return cheapestMove + costs_.perLiter * best;
+    }
+
+    auto lookahead(State s, int depth) const -> int {
+        if (depth == 0 || isGoal(s)) {
+            return baseHeuristic(s);
+        }
+        int64_t best = std::numeric_limits<int64_t>::max();
+        forEachSuccessor(s, [&](State next, int cost) {
+            best = std::min(best, cost + int64_t{lookahead(next, depth - 1)});
+        });
+        // Ходов нет только у сосудов нулевой ёмкости
+        if (best == std::numeric_limits<int64_t>::max()) {
+            return baseHeuristic(s);
+        }
+        return static_cast<int>(std::min<int64_t>(best, std::numeric_limits<int>::max()));
+    }
+
+    auto fillCost(int liters) const -> int { return costs_.fill + costs_.perLiter * liters; }
+    auto emptyCost(int liters) const -> int { return costs_.empty + costs_.perLiter * liters; }
+    auto pourCost(int liters) const -> int { return costs_.pour + costs_.perLiter * liters; }
+
+    std::vector<int> capacities_;
+    int targetVolume_;
+    MoveCosts costs_;
+    std::vector<unsigned> shifts_;
+    std::vector<uint64_t> masks_;
+    std::vector<size_t> strides_;
+    size_t stateCount_;
+    JugsBatchLayout batchLayout_;
+    BatchIsa batchIsa_ = BatchIsa::Scalar;
+    BatchKernel batchKernel_ = nullptr;
+    int heuristicLookahead_ = 1;
+};
+
+#endif
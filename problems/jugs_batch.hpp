@@ -0,0 +1,449 @@
+#ifndef JUGS_BATCH_HPP
+#define JUGS_BATCH_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define JUGS_BATCH_X86 1
+#else
+#define JUGS_BATCH_X86 0
+#endif
+
+// Пакетное раскрытие задачи о сосудах для поисков с битовым множеством
+// посещённых: по блоку плотных индексов ядро вычисляет индексы всех
+// преемников и отбрасывает уже посещённые. Индексы считаются без упаковки
+// состояния: наполнение сосуда i прибавляет (C_i - v_i) * stride_i,
+// опустошение вычитает v_i * stride_i, переливание i -> j прибавляет
+// t * (stride_j - stride_i), где t = min(v_i, C_j - v_j).
+//
+// В векторных ядрах каждая полоса — одно состояние блока, вычисления идут
+// в double: индексы меньше 2^32, так что все промежуточные значения точны,
+// а floor(r / stride) при r < 2^32 не ошибается на единицу. Посещённость
+// проверяется по всем полосам разом: слова битового множества читаются
+// сбором (AVX2, AVX-512) или двумя загрузками (SSE4.2), сдвигаются на номер
+// бита каждой полосы и сравниваются с нулём. Ядро выбирается один раз во
+// время выполнения по возможностям процессора, поэтому сборка не требует
+// флагов -m.
+//
+// Преемники выдаются в порядке «состояние блока, затем номер хода» и без
+// пустых ходов — как при последовательном forEachMove, — поэтому поиск,
+// перешедший на пакеты, обнаруживает состояния в прежнем порядке. Одно и то же новое состояние
+// может прийти от нескольких родителей блока: повторы отсекает вызывающий.
+
+struct BatchSuccessor {
+    uint32_t index;  // индекс преемника
+    uint32_t source; // позиция родителя во входном блоке
+    uint32_t move;   // номер хода, как в JugsProblem::forEachMove
+};
+
+inline constexpr size_t kMaxBatchJugs = 32;
+
+// Ёмкости и шаги плотного индекса по сосудам.
+struct JugsBatchLayout {
+    size_t jugs = 0;
+    uint32_t capacity[kMaxBatchJugs] = {};
+    uint32_t stride[kMaxBatchJugs] = {};
+};
+
+// Записывает в out не больше count * N(N+1) преемников, возвращает их число.
+using BatchKernel = size_t (*)(const JugsBatchLayout& layout,
+                               const uint32_t* indices,
+                               size_t count,
+                               const uint64_t* visited,
+                               BatchSuccessor* out);
+
+enum class BatchIsa {
+    Scalar,
+    Sse42,
+    Avx2,
+    Avx512,
+};
+
+namespace jugs_batch_detail {
+
+inline auto isVisited(const uint64_t* visited, uint32_t index) -> bool {
+    return visited[index >> 6] >> (index & 63) & 1;
+}
+
+inline auto expandScalar(const JugsBatchLayout& layout,
+                         const uint32_t* indices,
+                         size_t count,
+                         const uint64_t* visited,
+                         BatchSuccessor* out) -> size_t {
+    size_t jugs = layout.jugs;
+    size_t written = 0;
+    uint32_t volume[kMaxBatchJugs];
+
+    for (size_t k = 0; k < count; ++k) {
+        uint32_t index = indices[k];
+        uint32_t rest = index;
+        for (size_t i = 0; i < jugs; ++i) {
+            volume[i] = rest / layout.stride[i];
+            rest %= layout.stride[i];
+        }
+
+        uint32_t move = 0;
+        auto emit = [&](uint32_t next) {
+            if (next != index && !isVisited(visited, next)) {
+                out[written++] = {next, static_cast<uint32_t>(k), move};
+            }
+            move++;
+        };
+        for (size_t i = 0; i < jugs; ++i) {
+            emit(index + (layout.capacity[i] - volume[i]) * layout.stride[i]);
+        }
+        for (size_t i = 0; i < jugs; ++i) {
+            emit(index - volume[i] * layout.stride[i]);
+        }
+        for (size_t i = 0; i < jugs; ++i) {
+            for (size_t j = 0; j < jugs; ++j) {
+                if (i != j) {
+                    uint32_t transfer = std::min(volume[i], layout.capacity[j] - volume[j]);
+                    emit(index - transfer * layout.stride[i] + transfer * layout.stride[j]);
+                }
+            }
+        }
+    }
+    return written;
+}
+
+// Выдача результата векторного ядра: children[move * stride + lane] —
+// индексы преемников, fresh[move] — маска полос, где преемник не посещён.
+inline void emitLanes(const uint32_t* children, const uint32_t* fresh, size_t moves, size_t lanes,
+                      uint32_t any, size_t base, BatchSuccessor* out, size_t& written, size_t stride) {
+    for (size_t lane = 0; lane < lanes; ++lane) {
+        if (!(any >> lane & 1)) {
+            continue;
+        }
+        for (size_t move = 0; move < moves; ++move) {
+            if (fresh[move] >> lane & 1) {
+                out[written++] = {children[move * stride + lane], static_cast<uint32_t>(base + lane),
+                                  static_cast<uint32_t>(move)};
+            }
+        }
+    }
+}
+
+inline constexpr size_t kMaxBatchMoves = kMaxBatchJugs * (kMaxBatchJugs + 1);
+
+#if JUGS_BATCH_X86
+
+// 2^31 для перевода между uint32 и знаковыми преобразованиями SSE/AVX2.
+inline constexpr double kHalfRange = 2147483648.0;
+
+// Сохраняет индексы двух полос и возвращает маску ещё не посещённых. Сбора
+// в SSE нет: два слова битового множества читаются обычными загрузками,
+// а сдвиг на номер бита, своё для каждой полосы, — двумя сдвигами пары
+// слов со смешиванием результатов.
+__attribute__((target("sse4.2")))
+inline auto storeSse42(__m128d next, __m128d index, uint32_t* children, uint32_t activeMask, const uint64_t* visited)
+    -> uint32_t {
+    __m128i packed = _mm_xor_si128(_mm_cvttpd_epi32(_mm_sub_pd(next, _mm_set1_pd(kHalfRange))),
+                                   _mm_set1_epi32(INT32_MIN));
+    _mm_store_si128(reinterpret_cast<__m128i*>(children), packed);
+    uint32_t first = static_cast<uint32_t>(_mm_cvtsi128_si32(packed));
+    uint32_t second = static_cast<uint32_t>(_mm_extract_epi32(packed, 1));
+    __m128i word = _mm_set_epi64x(static_cast<long long>(visited[second >> 6]),
+                                  static_cast<long long>(visited[first >> 6]));
+    __m128i shifted = _mm_blend_epi16(_mm_srl_epi64(word, _mm_cvtsi32_si128(static_cast<int>(first & 63))),
+                                      _mm_srl_epi64(word, _mm_cvtsi32_si128(static_cast<int>(second & 63))), 0xF0);
+    __m128i bit = _mm_and_si128(shifted, _mm_set1_epi64x(1));
+    __m128i unseen = _mm_cmpeq_epi64(bit, _mm_setzero_si128());
+    // Пустой ход возвращает индекс родителя
+    uint32_t noop = static_cast<uint32_t>(_mm_movemask_pd(_mm_cmpeq_pd(next, index)));
+    return static_cast<uint32_t>(_mm_movemask_pd(_mm_castsi128_pd(unseen))) & ~noop & activeMask;
+}
+
+__attribute__((target("sse4.2")))
+inline auto expandSse42(const JugsBatchLayout& layout,
+                        const uint32_t* indices,
+                        size_t count,
+                        const uint64_t* visited,
+                        BatchSuccessor* out) -> size_t {
+    constexpr size_t lanes = 2;
+    size_t jugs = layout.jugs;
+    size_t moves = jugs * (jugs + 1);
+    size_t written = 0;
+    __m128d volume[kMaxBatchJugs];
+    __m128d capacity[kMaxBatchJugs];
+    __m128d stride[kMaxBatchJugs];
+    alignas(16) uint32_t children[kMaxBatchMoves * 4];
+    uint32_t fresh[kMaxBatchMoves];
+    for (size_t i = 0; i < jugs; ++i) {
+        capacity[i] = _mm_set1_pd(layout.capacity[i]);
+        stride[i] = _mm_set1_pd(layout.stride[i]);
+    }
+    const __m128d half = _mm_set1_pd(kHalfRange);
+    const __m128i flip = _mm_set1_epi32(INT32_MIN);
+
+    for (size_t base = 0; base < count; base += lanes) {
+        size_t active = std::min(lanes, count - base);
+        uint32_t second = active > 1 ? indices[base + 1] : indices[base];
+        __m128i raw = _mm_set_epi32(0, 0, static_cast<int>(second), static_cast<int>(indices[base]));
+        __m128d index = _mm_add_pd(_mm_cvtepi32_pd(_mm_xor_si128(raw, flip)), half);
+        uint32_t activeMask = (1u << active) - 1;
+
+        __m128d rest = index;
+        for (size_t i = 0; i < jugs; ++i) {
+            volume[i] = _mm_floor_pd(_mm_div_pd(rest, stride[i]));
+            rest = _mm_sub_pd(rest, _mm_mul_pd(volume[i], stride[i]));
+        }
+
+        uint32_t any = 0;
+        size_t move = 0;
+        for (size_t i = 0; i < jugs; ++i, ++move) {
+            any |= fresh[move] = storeSse42(_mm_add_pd(index, _mm_mul_pd(_mm_sub_pd(capacity[i], volume[i]), stride[i])),
+                                            index, children + move * 4, activeMask, visited);
+        }
+        for (size_t i = 0; i < jugs; ++i, ++move) {
+            any |= fresh[move] = storeSse42(_mm_sub_pd(index, _mm_mul_pd(volume[i], stride[i])),
+                                            index, children + move * 4, activeMask, visited);
+        }
+        for (size_t i = 0; i < jugs; ++i) {
+            for (size_t j = 0; j < jugs; ++j) {
+                if (i != j) {
+                    __m128d transfer = _mm_min_pd(volume[i], _mm_sub_pd(capacity[j], volume[j]));
+                    any |= fresh[move] = storeSse42(_mm_add_pd(index, _mm_mul_pd(transfer, _mm_sub_pd(stride[j], stride[i]))),
+                                                    index, children + move * 4, activeMask, visited);
+                    move++;
+                }
+            }
+        }
+        if (any) {
+            emitLanes(children, fresh, moves, active, any, base, out, written, 4);
+        }
+    }
+    return written;
+}
+
+// Сохраняет индексы четырёх полос и возвращает маску ещё не посещённых.
+__attribute__((target("avx2,fma")))
+inline auto storeAvx2(__m256d next, __m256d index, uint32_t* children, uint32_t activeMask, const uint64_t* visited)
+    -> uint32_t {
+    __m128i packed = _mm_xor_si128(_mm256_cvttpd_epi32(_mm256_sub_pd(next, _mm256_set1_pd(kHalfRange))),
+                                   _mm_set1_epi32(INT32_MIN));
+    _mm_store_si128(reinterpret_cast<__m128i*>(children), packed);
+    __m256i word = _mm256_i32gather_epi64(reinterpret_cast<const long long*>(visited),
+                                          _mm_srli_epi32(packed, 6), 8);
+    __m256i shift = _mm256_cvtepu32_epi64(_mm_and_si128(packed, _mm_set1_epi32(63)));
+    __m256i bit = _mm256_and_si256(_mm256_srlv_epi64(word, shift), _mm256_set1_epi64x(1));
+    __m256i unseen = _mm256_cmpeq_epi64(bit, _mm256_setzero_si256());
+    uint32_t noop = static_cast<uint32_t>(_mm256_movemask_pd(_mm256_cmp_pd(next, index, _CMP_EQ_OQ)));
+    return static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(unseen))) & ~noop & activeMask;
+}
+
+__attribute__((target("avx2,fma")))
+inline auto expandAvx2(const JugsBatchLayout& layout,
+                       const uint32_t* indices,
+                       size_t count,
+                       const uint64_t* visited,
+                       BatchSuccessor* out) -> size_t {
+    constexpr size_t lanes = 4;
+    size_t jugs = layout.jugs;
+    size_t moves = jugs * (jugs + 1);
+    size_t written = 0;
+    __m256d volume[kMaxBatchJugs];
+    __m256d capacity[kMaxBatchJugs];
+    __m256d stride[kMaxBatchJugs];
+    alignas(16) uint32_t children[kMaxBatchMoves * lanes];
+    uint32_t fresh[kMaxBatchMoves];
+    for (size_t i = 0; i < jugs; ++i) {
+        capacity[i] = _mm256_set1_pd(layout.capacity[i]);
+        stride[i] = _mm256_set1_pd(layout.stride[i]);
+    }
+    const __m256d half = _mm256_set1_pd(kHalfRange);
+    const __m128i flip = _mm_set1_epi32(INT32_MIN);
+
+    for (size_t base = 0; base < count; base += lanes) {
+        size_t active = std::min(lanes, count - base);
+        alignas(16) uint32_t block[lanes];
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            block[lane] = indices[base + std::min(lane, active - 1)];
+        }
+        __m128i raw = _mm_load_si128(reinterpret_cast<const __m128i*>(block));
+        __m256d index = _mm256_add_pd(_mm256_cvtepi32_pd(_mm_xor_si128(raw, flip)), half);
+        uint32_t activeMask = (1u << active) - 1;
+
+        __m256d rest = index;
+        for (size_t i = 0; i < jugs; ++i) {
+            volume[i] = _mm256_floor_pd(_mm256_div_pd(rest, stride[i]));
+            rest = _mm256_fnmadd_pd(volume[i], stride[i], rest);
+        }
+
+        uint32_t any = 0;
+        size_t move = 0;
+        for (size_t i = 0; i < jugs; ++i, ++move) {
+            any |= fresh[move] = storeAvx2(_mm256_fmadd_pd(_mm256_sub_pd(capacity[i], volume[i]), stride[i], index),
+                                           index, children + move * lanes, activeMask, visited);
+        }
+        for (size_t i = 0; i < jugs; ++i, ++move) {
+            any |= fresh[move] = storeAvx2(_mm256_fnmadd_pd(volume[i], stride[i], index),
+                                           index, children + move * lanes, activeMask, visited);
+        }
+        for (size_t i = 0; i < jugs; ++i) {
+            for (size_t j = 0; j < jugs; ++j) {
+                if (i != j) {
+                    __m256d transfer = _mm256_min_pd(volume[i], _mm256_sub_pd(capacity[j], volume[j]));
+                    any |= fresh[move] = storeAvx2(_mm256_fmadd_pd(transfer, _mm256_sub_pd(stride[j], stride[i]), index),
+                                                   index, children + move * lanes, activeMask, visited);
+                    move++;
+                }
+            }
+        }
+        if (any) {
+            emitLanes(children, fresh, moves, active, any, base, out, written, lanes);
+        }
+    }
+    return written;
+}
+
+// GCC 12 выдаёт на встроенные функции AVX-512 ложные предупреждения
+// о неинициализированном значении внутри avx512fintrin.h.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+__attribute__((target("avx512f")))
+inline auto storeAvx512(__m512d next, __m512d index, uint32_t* children, __mmask8 activeMask, const uint64_t* visited)
+    -> uint32_t {
+    __m256i packed = _mm512_cvttpd_epu32(next);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(children), packed);
+    __m512i word = _mm512_i32gather_epi64(_mm256_srli_epi32(packed, 6), visited, 8);
+    __m512i shift = _mm512_cvtepu32_epi64(_mm256_and_si256(packed, _mm256_set1_epi32(63)));
+    __mmask8 seen = _mm512_test_epi64_mask(_mm512_srlv_epi64(word, shift), _mm512_set1_epi64(1));
+    __mmask8 noop = _mm512_cmp_pd_mask(next, index, _CMP_EQ_OQ);
+    return static_cast<uint32_t>(~seen & ~noop & activeMask);
+}
+
+__attribute__((target("avx512f")))
+inline auto expandAvx512(const JugsBatchLayout& layout,
+                         const uint32_t* indices,
+                         size_t count,
+                         const uint64_t* visited,
+                         BatchSuccessor* out) -> size_t {
+    constexpr size_t lanes = 8;
+    size_t jugs = layout.jugs;
+    size_t moves = jugs * (jugs + 1);
+    size_t written = 0;
+    __m512d volume[kMaxBatchJugs];
+    __m512d capacity[kMaxBatchJugs];
+    __m512d stride[kMaxBatchJugs];
+    alignas(32) uint32_t children[kMaxBatchMoves * lanes];
+    uint32_t fresh[kMaxBatchMoves];
+    for (size_t i = 0; i < jugs; ++i) {
+        capacity[i] = _mm512_set1_pd(layout.capacity[i]);
+        stride[i] = _mm512_set1_pd(layout.stride[i]);
+    }
+
+    for (size_t base = 0; base < count; base += lanes) {
+        size_t active = std::min(lanes, count - base);
+        __mmask8 activeMask = static_cast<__mmask8>((1u << active) - 1);
+        // Неактивные полосы повторяют последнюю: их результат маскируется
+        alignas(32) uint32_t block[lanes];
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            block[lane] = indices[base + std::min(lane, active - 1)];
+        }
+        __m512d index = _mm512_cvtepu32_pd(_mm256_load_si256(reinterpret_cast<const __m256i*>(block)));
+
+        __m512d rest = index;
+        for (size_t i = 0; i < jugs; ++i) {
+            volume[i] = _mm512_roundscale_pd(_mm512_div_pd(rest, stride[i]), _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+            rest = _mm512_fnmadd_pd(volume[i], stride[i], rest);
+        }
+
+        uint32_t any = 0;
+        size_t move = 0;
+        for (size_t i = 0; i < jugs; ++i, ++move) {
+            any |= fresh[move] = storeAvx512(_mm512_fmadd_pd(_mm512_sub_pd(capacity[i], volume[i]), stride[i], index),
+                                             index, children + move * lanes, activeMask, visited);
+        }
+        for (size_t i = 0; i < jugs; ++i, ++move) {
+            any |= fresh[move] = storeAvx512(_mm512_fnmadd_pd(volume[i], stride[i], index),
+                                             index, children + move * lanes, activeMask, visited);
+        }
+        for (size_t i = 0; i < jugs; ++i) {
+            for (size_t j = 0; j < jugs; ++j) {
+                if (i != j) {
+                    __m512d transfer = _mm512_min_pd(volume[i], _mm512_sub_pd(capacity[j], volume[j]));
+                    any |= fresh[move] = storeAvx512(_mm512_fmadd_pd(transfer, _mm512_sub_pd(stride[j], stride[i]), index),
+                                                     index, children + move * lanes, activeMask, visited);
+                    move++;
+                }
+            }
+        }
+        if (any) {
+            emitLanes(children, fresh, moves, active, any, base, out, written, lanes);
+        }
+    }
+    return written;
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif
+
+} // namespace jugs_batch_detail
+
+// Лучший набор инструкций, который поддерживает процессор. Определяется
+// один раз при первом вызове.
+inline auto detectBatchIsa() -> BatchIsa {
+#if JUGS_BATCH_X86
+    static const BatchIsa isa = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            return BatchIsa::Avx512;
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return BatchIsa::Avx2;
+        }
+        if (__builtin_cpu_supports("sse4.2")) {
+            return BatchIsa::Sse42;
+        }
+        return BatchIsa::Scalar;
+    }();
+    return isa;
+#else
+    return BatchIsa::Scalar;
+#endif
+}
+
+inline auto batchIsaName(BatchIsa isa) -> const char* {
+    switch (isa) {
+    case BatchIsa::Scalar:
+        return "scalar";
+    case BatchIsa::Sse42:
+        return "sse4.2";
+    case BatchIsa::Avx2:
+        return "avx2";
+    case BatchIsa::Avx512:
+        return "avx512";
+    }
+    return "?";
+}
+
+// Ядро для набора инструкций; набор должен поддерживаться процессором.
+inline auto batchKernel(BatchIsa isa) -> BatchKernel {
+#if JUGS_BATCH_X86
+    switch (isa) {
+    case BatchIsa::Scalar:
+        break;
+    case BatchIsa::Sse42:
+        return jugs_batch_detail::expandSse42;
+    case BatchIsa::Avx2:
+        return jugs_batch_detail::expandAvx2;
+    case BatchIsa::Avx512:
+        return jugs_batch_detail::expandAvx512;
+    }
+#else
+    (void)isa;
+#endif
+    return jugs_batch_detail::expandScalar;
+}
+
+#endif
@@ -0,0 +1,146 @@
+#ifndef JUGS_SYMMETRY_HPP
+#define JUGS_SYMMETRY_HPP
+
+#include "jugs.hpp"
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// Задача о сосудах, сокращённая по симметрии: сосуды равной ёмкости
+// взаимозаменяемы — перестановка их объёмов сохраняет цели, стоимости
+// ходов и эвристику. Поэтому поиск ведётся по каноническим состояниям, где
+// объёмы внутри каждой группы равных ёмкостей упорядочены по убыванию, и
+// пространство сжимается примерно в произведение факториалов размеров
+// групп. Нумерация прежняя, просто неканонические индексы не посещаются.
+//
+// Разные ходы из одного состояния могут вести в одно каноническое
+// состояние, иногда с разной стоимостью (например, переливания разного
+// объёма в равные сосуды); такие преемники выдаются один раз, с меньшей
+// стоимостью. Путь из канонических состояний переводит обратно в исходную
+// нумерацию сосудов restorePath.
+class SymmetricJugsProblem {
+public:
+    using State = JugsProblem::State;
+    using Index = JugsProblem::Index;
+
+    explicit SymmetricJugsProblem(const JugsProblem& problem) : problem_(problem) {
+        size_t jugs = problem.jugCount();
+        std::vector<bool> grouped(jugs, false);
+        for (size_t i = 0; i < jugs; ++i) {
+            if (grouped[i] || problem.capacity(i) == 0) {
+                continue;
+            }
+            std::vector<size_t> group = {i};
+            for (size_t j = i + 1; j < jugs; ++j) {
+                if (problem.capacity(j) == problem.capacity(i)) {
+                    group.push_back(j);
+                    grouped[j] = true;
+                }
+            }
+            if (group.size() > 1) {
+                groups_.push_back(std::move(group));
+            }
+        }
+    }
+
+    // Есть ли что сокращать: хотя бы два сосуда равной ненулевой ёмкости.
+    static auto hasSymmetry(const JugsProblem& problem) -> bool {
+        for (size_t i = 0; i < problem.jugCount(); ++i) {
+            for (size_t j = i + 1; j < problem.jugCount(); ++j) {
+                if (problem.capacity(i) == problem.capacity(j) && problem.capacity(i) > 0) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    auto canonical(State s) const -> State {
+        for (const std::vector<size_t>& group : groups_) {
+            // Группы малы: сортировка вставками по убыванию
+            for (size_t k = 1; k < group.size(); ++k) {
+                int value = problem_.volume(s, group[k]);
+                size_t m = k;
+                for (; m > 0 && problem_.volume(s, group[m - 1]) < value; --m) {
+                    s = problem_.withVolume(s, group[m], problem_.volume(s, group[m - 1]));
+                }
+                s = problem_.withVolume(s, group[m], value);
+            }
+        }
+        return s;
+    }
+
+    auto initial() const -> State { return canonical(problem_.initial()); }
+    auto isGoal(State s) const -> bool { return problem_.isGoal(s); }
+
+    template <typename Visit>
+    void forEachSuccessor(State current, Visit&& visit) const {
+        std::array<Successor, kInlineMoves> inlineBuffer; // без инициализации
+        std::vector<Successor> heapBuffer;
+        Successor* successors = inlineBuffer.data();
+        if (static_cast<size_t>(problem_.moveCount()) > kInlineMoves) {
+            heapBuffer.resize(static_cast<size_t>(problem_.moveCount()));
+            successors = heapBuffer.data();
+        }
+
+        size_t count = 0;
+        problem_.forEachSuccessor(current, [&](State next, int cost) {
+            uint64_t reduced = canonical(next).word;
+            for (size_t k = 0; k < count; ++k) {
+                if (successors[k].word == reduced) {
+                    successors[k].cost = std::min(successors[k].cost, cost);
+                    return;
+                }
+            }
+            successors[count++] = {reduced, cost};
+        });
+        for (size_t k = 0; k < count; ++k) {
+            visit(State{successors[k].word}, successors[k].cost);
+        }
+    }
+
+    auto heuristic(State s) const -> int { return problem_.heuristic(s); }
+    auto stateCount() const -> size_t { return problem_.stateCount(); }
+    auto indexOf(State s) const -> Index { return problem_.indexOf(s); }
+    auto stateOf(Index index) const -> State { return problem_.stateOf(index); }
+    void print(std::ostream& out, State s) const { problem_.print(out, s); }
+
+    // Путь по каноническим состояниям — в путь исходной задачи той же
+    // стоимости: из настоящего состояния берётся самый дешёвый ход, чей
+    // результат канонически совпадает со следующим состоянием пути.
+    auto restorePath(const std::vector<State>& path) const -> std::vector<State> {
+        std::vector<State> restored;
+        if (path.empty()) {
+            return restored;
+        }
+        restored.reserve(path.size());
+        restored.push_back(problem_.initial());
+        for (size_t k = 1; k < path.size(); ++k) {
+            State best = restored.back();
+            int bestCost = std::numeric_limits<int>::max();
+            problem_.forEachSuccessor(restored.back(), [&](State next, int cost) {
+                if (cost < bestCost && canonical(next) == path[k]) {
+                    best = next;
+                    bestCost = cost;
+                }
+            });
+            restored.push_back(best);
+        }
+        return restored;
+    }
+
+private:
+    struct Successor {
+        uint64_t word;
+        int cost;
+    };
+
+    static constexpr size_t kInlineMoves = 64; // до семи сосудов без выделения памяти
+
+    const JugsProblem& problem_;
+    std::vector<std::vector<size_t>> groups_;
+};
+
+#endif
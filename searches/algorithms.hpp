@@ -0,0 +1,128 @@
+#ifndef ALGORITHMS_HPP
+#define ALGORITHMS_HPP
+
+#include "../problems/jugs.hpp"
+#include "../problems/jugs_symmetry.hpp"
+#include "bfs.hpp"
+#include "succinct_bfs.hpp"
+#include "ucs.hpp"
+#include "dfs.hpp"
+#include "astar.hpp"
+#include "bidirectional_bfs.hpp"
+#include "parallel_bfs.hpp"
+#include "hda_star.hpp"
+#include "iterative_deepening.hpp"
+#include "external_bfs.hpp"
+#include "solution_cache.hpp"
+#include "closed_form.hpp"
+#include "pattern_database.hpp"
+#include "portfolio.hpp"
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Что гарантирует путь, найденный алгоритмом.
+enum class Optimality {
+    None,  // какой-нибудь путь
+    Moves, // кратчайший по числу ходов
+    Cost,  // минимальный по стоимости в модели стоимости задачи
+};
+
+struct JugsAlgorithm {
+    AlgorithmFunction<JugsProblem> function;
+    std::string name;        // для файлов и машиночитаемых отчетов
+    std::string displayName; // для вывода в консоль
+    Optimality optimality;
+};
+
+// Путь минимален по стоимости: по числу ходов — только при единичных стоимостях.
+inline auto isCostOptimal(const JugsAlgorithm& algorithm, const JugsProblem& problem) -> bool {
+    return algorithm.optimality == Optimality::Cost
+           || (algorithm.optimality == Optimality::Moves && problem.costs().isUnit());
+}
+
+// Поиск по задаче, сокращённой симметрией сосудов равной ёмкости; путь
+// возвращается в исходной нумерации сосудов.
+template <AlgorithmFunction<SymmetricJugsProblem> Search>
+inline auto symmetric(const JugsProblem& problem,
+                      StateStore& store,
+                      const SearchOptions& options = {}) -> SearchResult<JugsProblem::State> {
+    SymmetricJugsProblem reduced(problem);
+    SearchResult<JugsProblem::State> result = Search(reduced, store, options);
+    result.path = reduced.restorePath(result.path);
+    return result;
+}
+
+// Имена всех алгоритмов, которые может вернуть jugsAlgorithms при какой-либо
+// конфигурации, — для проверки списков алгоритмов в параметрах утилит.
+inline auto jugsAlgorithmNames() -> std::vector<std::string> {
+    return {"bfs", "ucs", "dfs", "astar", "bibfs", "pbfs", "hdastar", "iddfs", "idastar", "ebfs", "sbfs",
+            "bfs_sym", "ucs_sym", "astar_sym", "cached_bfs", "astar_pdb", "closed_form"};
+}
+
+// Все алгоритмы, применимые к данной конфигурации сосудов, в порядке запуска.
+inline auto jugsAlgorithms(const JugsProblem& problem,
+                           const SearchOptions& options = {}) -> std::vector<JugsAlgorithm> {
+    std::vector<JugsAlgorithm> algorithms = {
+        {bfs<JugsProblem>, "bfs", "BFS", Optimality::Moves},
+        {ucs<JugsProblem>, "ucs", "UCS", Optimality::Cost},
+        {dfs<JugsProblem>, "dfs", "DFS", Optimality::None},
+        {astar<JugsProblem>, "astar", "A*", Optimality::Cost},
+        {bidirectionalBfs<JugsProblem>, "bibfs", "BiBFS", Optimality::Moves},
+        {parallelBfs<JugsProblem>, "pbfs", "Parallel BFS", Optimality::Moves},
+        {hdaStar<JugsProblem>, "hdastar", "HDA*", Optimality::Cost},
+        {iddfs<JugsProblem>, "iddfs", "IDDFS", Optimality::Moves},
+        {idaStar<JugsProblem>, "idastar", "IDA*", Optimality::Cost},
+        {externalBfs, "ebfs", "External BFS", Optimality::Moves},
+        {succinctBfs<JugsProblem>, "sbfs", "Succinct BFS", Optimality::Moves},
+    };
+
+    // Сокращение по симметрии — только если есть сосуды равной ёмкости
+    if (SymmetricJugsProblem::hasSymmetry(problem)) {
+        algorithms.push_back({symmetric<bfs<SymmetricJugsProblem>>, "bfs_sym", "BFS (симметрия)", Optimality::Moves});
+        algorithms.push_back({symmetric<ucs<SymmetricJugsProblem>>, "ucs_sym", "UCS (симметрия)", Optimality::Cost});
+        algorithms.push_back({symmetric<astar<SymmetricJugsProblem>>, "astar_sym", "A* (симметрия)", Optimality::Cost});
+    }
+
+    // Ответ из постоянного кэша — только если он подключен
+    if (options.cache) {
+        algorithms.push_back({cachedBfs, "cached_bfs", "BFS из кэша", Optimality::Moves});
+    }
+
+    // A* по базе шаблонов — только если загружена подходящая база
+    if (options.patterns && options.patterns->matches(problem)) {
+        algorithms.push_back({astarPdb, "astar_pdb", "A* (PDB)", Optimality::Cost});
+    }
+
+    // Для двух сосудов доступно решение по формуле без поиска
+    if (problem.jugCount() == 2) {
+        algorithms.push_back({closedFormSolve, "closed_form", "Формула", Optimality::Moves});
+    }
+
+    return algorithms;
+}
+
+// Требование к ответу портфеля.
+enum class PortfolioQuality {
+    Any,     // первый найденный путь
+    Optimal, // первый путь минимальной стоимости
+};
+
+// Портфель из набора алгоритмов: при Optimal в него входят только алгоритмы
+// с гарантией минимальной стоимости.
+inline auto jugsPortfolio(const JugsProblem& problem,
+                          const std::vector<JugsAlgorithm>& algorithms,
+                          PortfolioQuality quality) -> std::vector<PortfolioEntry<JugsProblem>> {
+    std::vector<PortfolioEntry<JugsProblem>> entries;
+    for (const JugsAlgorithm& algorithm : algorithms) {
+        if (quality == PortfolioQuality::Any || isCostOptimal(algorithm, problem)) {
+            entries.push_back({algorithm.function, algorithm.name});
+        }
+    }
+    if (entries.empty()) {
+        throw std::invalid_argument("в портфеле нет алгоритма с гарантией оптимальности");
+    }
+    return entries;
+}
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef BIDIRECTIONAL_BFS_HPP
+#define BIDIRECTIONAL_BFS_HPP
+
+#include "engine.hpp"
+#include <limits>
+#include <optional>
+
+// Задача, допускающая обратный поиск: перечисление всех целевых состояний
+// и генерация предшественников.
+template <typename P>
+concept ReversibleProblem = SearchProblem<P> && requires(const P& p, const typename P::State& s) {
+    p.forEachPredecessor(s, [](const typename P::State&, int) {});
+    p.forEachGoal([](const typename P::State&) {});
+};
+
+// Двунаправленный поиск в ширину для единичных стоимостей: прямой фронт
+// растёт от начального состояния, обратный — от множества всех целей.
+// За шаг целиком раскрывается слой меньшего фронта; если в слое фронты
+// встретились, минимум по всем встречам слоя даёт кратчайший путь.
+template <ReversibleProblem Problem>
+inline auto bidirectionalBfs(const Problem& problem,
+                             StateStore& store,
+                             const SearchOptions& options = {}) -> SearchResult<typename Problem::State> {
+
+    using State = typename Problem::State;
+    using Index = StateStore::Index;
+
+    SearchTree* tree = options.tree;
+    StateStore& forward = store;
+    std::optional<StateStore> ownBackward;
+    StateStore& backward = options.workspace ? options.workspace->auxiliaryStore(problem.stateCount())
+                                             : ownBackward.emplace(problem.stateCount());
+
+    std::pmr::memory_resource* resource = searchResource(options);
+    std::pmr::vector<Index> forwardFrontier(resource);
+    std::pmr::vector<Index> backwardFrontier(resource);
+    std::pmr::vector<Index> nextFrontier(resource);
+
+    State initial = problem.initial();
+    Index startIndex = problem.indexOf(initial);
+    forward.setRoot(startIndex);
+    if (tree) {
+        tree->addRoot(startIndex);
+    }
+    forwardFrontier.push_back(startIndex);
+
+    problem.forEachGoal([&](const State& goal) {
+        Index goalIndex = problem.indexOf(goal);
+        backward.setRoot(goalIndex);
+        if (tree) {
+            tree->addRoot(goalIndex);
+        }
+        backwardFrontier.push_back(goalIndex);
+    });
+
+    SearchResult<State> result;
+    int bestLength = std::numeric_limits<int>::max();
+    Index meetIndex = startIndex;
+
+    if (backward.isDiscovered(startIndex)) {
+        bestLength = 0;
+    }
+
+    while (bestLength == std::numeric_limits<int>::max()
+           && !forwardFrontier.empty() && !backwardFrontier.empty()) {
+        bool forwardStep = forwardFrontier.size() <= backwardFrontier.size();
+        std::pmr::vector<Index>& frontier = forwardStep ? forwardFrontier : backwardFrontier;
+        StateStore& own = forwardStep ? forward : backward;
+        StateStore& other = forwardStep ? backward : forward;
+
+        nextFrontier.clear();
+        for (Index currentIndex : frontier) {
+            if (stopRequested(options, result.visitedNodes)) {
+                return result;
+            }
+            result.visitedNodes++;
+            int nextCost = own.costOf(currentIndex) + 1;
+
+            auto relax = [&](const State& nextState, int) {
+                Index nextIndex = problem.indexOf(nextState);
+                if (own.isDiscovered(nextIndex)) {
+                    return;
+                }
+                if (tree) {
+                    tree->addEdge(currentIndex, nextIndex);
+                }
+                own.setParent(nextIndex, currentIndex, nextCost);
+                nextFrontier.push_back(nextIndex);
+                if (other.isDiscovered(nextIndex) && nextCost + other.costOf(nextIndex) < bestLength) {
+                    bestLength = nextCost + other.costOf(nextIndex);
+                    meetIndex = nextIndex;
+                }
+            };
+
+            if (forwardStep) {
+                problem.forEachSuccessor(problem.stateOf(currentIndex), relax);
+            } else {
+                problem.forEachPredecessor(problem.stateOf(currentIndex), relax);
+            }
+        }
+        frontier.swap(nextFrontier);
+    }
+
+    if (bestLength != std::numeric_limits<int>::max()) {
+        result.pathFound = true;
+        result.path = forward.pathTo(problem, meetIndex);
+        for (Index current = meetIndex; !backward.isRoot(current);) {
+            current = backward.parentOf(current);
+            result.path.push_back(problem.stateOf(current));
+        }
+    }
+
+    return result;
+}
+
+#endif
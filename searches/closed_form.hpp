@@ -0,0 +1,127 @@
+#ifndef CLOSED_FORM_HPP
+#define CLOSED_FORM_HPP
+
+#include "../problems/jugs.hpp"
+#include "../misc/state_store.hpp"
+#include "../misc/search_tree.hpp"
+#include <cstdint>
+#include <tuple>
+
+// Решение задачи о двух сосудах без поиска. Оптимальный путь из (A, 0)
+// всегда даёт одна из двух стратегий «переливать из x в y»: если x пуст —
+// наполнить x, иначе если y полон — вылить y, иначе перелить x -> y.
+// Длину каждой стратегии считаем по расширенному алгоритму Евклида,
+// затем воспроизводим более короткую.
+
+namespace closed_form_detail {
+
+// Возвращает (g, u, v), где a*u + b*v = g = НОД(a, b).
+inline auto extendedGcd(int64_t a, int64_t b) -> std::tuple<int64_t, int64_t, int64_t> {
+    int64_t u0 = 1, u1 = 0;
+    int64_t v0 = 0, v1 = 1;
+    while (b != 0) {
+        int64_t q = a / b;
+        std::tie(a, b) = std::make_tuple(b, a - q * b);
+        std::tie(u0, u1) = std::make_tuple(u1, u0 - q * u1);
+        std::tie(v0, v1) = std::make_tuple(v1, v0 - q * v1);
+    }
+    return {a, u0, v0};
+}
+
+// Число ходов стратегии «переливать из x в y» от состояния (x полон, y пуст)
+// до появления target в одном из сосудов, или -1. Если понадобилось k
+// наполнений x и m опустошений y, то k*x ≡ target (mod y); наименьшее
+// k >= 1 даёт обратный элемент x/g по модулю y/g. Цель оказывается в x,
+// когда y только что заполнился, иначе — в y, когда x только что опустел.
+inline auto pourStrategyLength(int64_t x, int64_t y, int64_t target) -> int64_t {
+    if (target == x || target == 0) {
+        return 0;
+    }
+    if (y == 0) {
+        return -1;
+    }
+    auto [g, u, v] = extendedGcd(x, y);
+    if (target % g != 0) {
+        return -1;
+    }
+    int64_t modulus = y / g;
+    int64_t fills = ((target / g) % modulus * (u % modulus) % modulus + modulus) % modulus;
+    if (fills == 0) {
+        fills = modulus;
+    }
+    int64_t empties = (fills * x - target) / y;
+    if (target <= x && empties >= 1) {
+        return 2 * (fills + empties - 1) - 1;
+    }
+    return 2 * (fills + empties) - 1;
+}
+
+} // namespace closed_form_detail
+
+inline auto closedFormSolve(const JugsProblem& problem,
+                            StateStore&,
+                            const SearchOptions& options = {}) -> SearchResult<PackedState> {
+
+    using namespace closed_form_detail;
+    using State = PackedState;
+
+    SearchResult<State> result;
+    if (problem.jugCount() != 2 || !problem.isSolvable()) {
+        return result;
+    }
+
+    int64_t a = problem.capacity(0);
+    int64_t b = problem.capacity(1);
+    int64_t target = problem.targetVolume();
+
+    // Стратегия B -> A начинается с двух подготовительных ходов:
+    // наполнить B и вылить A. Если target == B, хватает первого из них.
+    int64_t viaFirst = pourStrategyLength(a, b, target);
+    int64_t viaSecond = target == b ? -1 : pourStrategyLength(b, a, target);
+    if (viaSecond >= 0) {
+        viaSecond += 2;
+    }
+    if (target == b && viaFirst != 0) {
+        viaSecond = 1;
+    }
+
+    bool firstToSecond = viaSecond < 0 || (viaFirst >= 0 && viaFirst <= viaSecond);
+    int64_t steps = firstToSecond ? viaFirst : viaSecond;
+    size_t from = firstToSecond ? 0 : 1;
+    size_t to = 1 - from;
+
+    State current = problem.initial();
+    StateStore::Index currentIndex = problem.indexOf(current);
+    SearchTree* tree = options.tree;
+    if (tree) {
+        tree->addRoot(currentIndex);
+    }
+    result.path.reserve(static_cast<size_t>(steps) + 1);
+    result.path.push_back(current);
+
+    for (int64_t step = 0; step < steps; ++step) {
+        int fromVolume = problem.volume(current, from);
+        int toVolume = problem.volume(current, to);
+        if (fromVolume == 0) {
+            current = problem.withVolume(current, from, problem.capacity(from));
+        } else if (toVolume == problem.capacity(to)) {
+            current = problem.withVolume(current, to, 0);
+        } else {
+            int transfer = std::min(fromVolume, problem.capacity(to) - toVolume);
+            current = problem.withVolume(problem.withVolume(current, from, fromVolume - transfer),
+                                         to, toVolume + transfer);
+        }
+        StateStore::Index nextIndex = problem.indexOf(current);
+        if (tree) {
+            tree->addEdge(currentIndex, nextIndex);
+        }
+        currentIndex = nextIndex;
+        result.path.push_back(current);
+    }
+
+    result.pathFound = problem.isGoal(current);
+    result.visitedNodes = static_cast<uint32_t>(result.path.size());
+    return result;
+}
+
+#endif
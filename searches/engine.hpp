@@ -0,0 +1,282 @@
+#ifndef ENGINE_HPP
+#define ENGINE_HPP
+
+#include "../misc/state_store.hpp"
+#include "../misc/search_tree.hpp"
+#include "../misc/instrumentation.hpp"
+#include "../misc/search_workspace.hpp"
+#include "open_lists.hpp"
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Требования к задаче: тип состояния, плотная нумерация состояний,
+// начальное состояние, проверка цели, генератор преемников со стоимостью
+// хода и эвристика. Генератор принимает посетителя, поэтому весь цикл
+// раскрытия инстанцируется и встраивается без косвенных вызовов.
+template <typename P>
+concept SearchProblem = requires(const P& p,
+                                 const typename P::State& s,
+                                 StateStore::Index i,
+                                 std::ostream& out) {
+    typename P::State;
+    { p.initial() } -> std::convertible_to<typename P::State>;
+    { p.isGoal(s) } -> std::convertible_to<bool>;
+    p.forEachSuccessor(s, [](const typename P::State&, int) {});
+    { p.heuristic(s) } -> std::convertible_to<int>;
+    { p.stateCount() } -> std::convertible_to<size_t>;
+    { p.indexOf(s) } -> std::convertible_to<StateStore::Index>;
+    { p.stateOf(i) } -> std::convertible_to<typename P::State>;
+    p.print(out, s);
+};
+
+// Сумма стоимостей пути (g + c, g + h). Стоимости и приоритеты — int;
+// переполнение сломало бы порядок открытого списка, поэтому оно — ошибка.
+inline auto addCost(int a, int b) -> int {
+    int sum;
+    if (__builtin_add_overflow(a, b, &sum)) {
+        throw std::overflow_error("стоимость пути не помещается в int");
+    }
+    return sum;
+}
+
+// Бюджет одного шага возобновляемого поиска: шаг заканчивается, когда
+// исчерпано любое из ограничений. Срок сверяется с часами раз в
+// kDeadlineCheckInterval раскрытий, так что шаг может превысить его на
+// время этих раскрытий.
+struct SearchBudget {
+    uint64_t expansions = std::numeric_limits<uint64_t>::max();
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+};
+
+inline constexpr uint32_t kDeadlineCheckInterval = 256;
+
+enum class SearchStatus {
+    Running,   // бюджет шага исчерпан, поиск можно продолжить
+    Found,     // путь найден
+    Exhausted, // открытый список пуст: пути нет
+    Stopped,   // остановлен через SearchOptions::stop
+};
+
+inline auto statusName(SearchStatus status) -> const char* {
+    switch (status) {
+    case SearchStatus::Running:
+        return "running";
+    case SearchStatus::Found:
+        return "found";
+    case SearchStatus::Exhausted:
+        return "exhausted";
+    case SearchStatus::Stopped:
+        return "stopped";
+    }
+    return "?";
+}
+
+struct SearchProgress {
+    uint32_t expanded = 0; // раскрыто за все шаги
+    size_t openSize = 0;   // вершин в открытом списке
+    uint32_t steps = 0;    // сделано шагов
+    double seconds = 0;    // время внутри шагов, без пауз между ними
+};
+
+// Единое ядро поиска на графе в виде возобновляемого сеанса. Порядок
+// раскрытия задаёт политика открытого списка, Informed добавляет к
+// приоритету эвристику задачи. step() раскрывает вершины в пределах
+// бюджета и возвращает состояние поиска; открытый список и хранилище
+// сохраняются между шагами, поэтому серия шагов раскрывает вершины в том же
+// порядке, что и один неограниченный шаг. Так один поток может вести
+// несколько поисков вперемешку или отвечать частичным результатом к сроку.
+//
+// Сеанс ссылается на задачу и хранилище, а память открытого списка берёт из
+// рабочего пространства SearchOptions: всё это должно жить до конца сеанса,
+// а рабочее пространство — не сбрасываться.
+template <typename OpenList, bool Informed, SearchProblem Problem>
+class SearchSession {
+public:
+    using State = typename Problem::State;
+    using Index = StateStore::Index;
+
+    SearchSession(const Problem& problem, StateStore& store, const SearchOptions& options = {})
+        : problem_(problem),
+          store_(store),
+          options_(options),
+          open_(searchResource(options)),
+          probe_(options.stats),
+          successors_(searchResource(options)) {
+        State initial = problem_.initial();
+        Index startIndex = problem_.indexOf(initial);
+        store_.setRoot(startIndex);
+        if (options_.tree) {
+            options_.tree->addRoot(startIndex);
+        }
+        open_.push({priority(0, initial), 0, startIndex});
+    }
+
+    SearchSession(const SearchSession&) = delete;
+    auto operator=(const SearchSession&) -> SearchSession& = delete;
+
+    auto step(const SearchBudget& budget = {}) -> SearchStatus {
+        if (status_ != SearchStatus::Running) {
+            return status_;
+        }
+        auto startTime = std::chrono::steady_clock::now();
+        status_ = expand(budget);
+        progress_.steps++;
+        progress_.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        if (status_ != SearchStatus::Running) {
+            finish();
+        }
+        return status_;
+    }
+
+    auto status() const -> SearchStatus { return status_; }
+
+    auto progress() const -> SearchProgress {
+        SearchProgress progress = progress_;
+        progress.expanded = result_.visitedNodes;
+        progress.openSize = open_.size();
+        return progress;
+    }
+
+    // Результат: путь — только в состоянии Found.
+    auto result() const -> const SearchResult<State>& { return result_; }
+    auto takeResult() -> SearchResult<State> { return std::move(result_); }
+
+private:
+    auto priority(int cost, const State& s) const -> int {
+        if constexpr (Informed) {
+            return addCost(cost, problem_.heuristic(s));
+        } else {
+            return cost;
+        }
+    }
+
+    auto expand(const SearchBudget& budget) -> SearchStatus {
+        SearchTree* tree = options_.tree;
+        bool timed = budget.deadline != std::chrono::steady_clock::time_point::max();
+        uint64_t stepExpanded = 0;
+
+        while (!open_.empty()) {
+            if (stepExpanded >= budget.expansions
+                || (timed && stepExpanded % kDeadlineCheckInterval == 0
+                    && std::chrono::steady_clock::now() >= budget.deadline)) {
+                return SearchStatus::Running;
+            }
+
+            OpenEntry current = open_.pop();
+
+            if constexpr (OpenList::kBestFirst) {
+                probe_.count(&SearchStats::probes);
+                if (store_.costOf(current.index) < current.cost) {
+                    probe_.count(&SearchStats::stalePops);
+                    continue;
+                }
+            }
+
+            if (stopRequested(options_, result_.visitedNodes)) {
+                return SearchStatus::Stopped;
+            }
+            result_.visitedNodes++;
+            stepExpanded++;
+            probe_.count(&SearchStats::expansions);
+
+            State currentState = problem_.stateOf(current.index);
+
+            if (probe_.timed(&SearchStats::goalTestSeconds, [&] { return problem_.isGoal(currentState); })) {
+                targetIndex_ = current.index;
+                return SearchStatus::Found;
+            }
+
+            auto relax = [&](const State& nextState, int stepCost) {
+                int nextCost = addCost(current.cost, stepCost);
+                Index nextIndex = problem_.indexOf(nextState);
+                probe_.count(&SearchStats::generated);
+                probe_.count(&SearchStats::probes);
+
+                if (!store_.isDiscovered(nextIndex)) {
+                    if (tree) {
+                        tree->addEdge(current.index, nextIndex);
+                    }
+                    store_.setParent(nextIndex, current.index, nextCost);
+                    open_.push({priority(nextCost, nextState), nextCost, nextIndex});
+                    probe_.observeMax(&SearchStats::peakOpenSize, open_.size());
+                    return;
+                }
+
+                probe_.count(&SearchStats::duplicates);
+                if constexpr (OpenList::kBestFirst) {
+                    if (nextCost < store_.costOf(nextIndex)) {
+                        store_.setParent(nextIndex, current.index, nextCost);
+                        open_.push({priority(nextCost, nextState), nextCost, nextIndex});
+                        probe_.observeMax(&SearchStats::peakOpenSize, open_.size());
+                    }
+                }
+            };
+
+            // Чтобы замерить генерацию отдельно от обработки преемников,
+            // в инструментированной сборке они сначала собираются в буфер.
+            if constexpr (kSearchInstrumentation) {
+                if (probe_.enabled()) {
+                    successors_.clear();
+                    probe_.timed(&SearchStats::successorSeconds, [&] {
+                        problem_.forEachSuccessor(currentState, [&](const State& nextState, int stepCost) {
+                            successors_.emplace_back(nextState, stepCost);
+                        });
+                    });
+                    for (const auto& [nextState, stepCost] : successors_) {
+                        relax(nextState, stepCost);
+                    }
+                    continue;
+                }
+            }
+
+            problem_.forEachSuccessor(currentState, relax);
+        }
+
+        return SearchStatus::Exhausted;
+    }
+
+    void finish() {
+        if (status_ == SearchStatus::Found) {
+            result_.pathFound = true;
+            result_.path = probe_.timed(&SearchStats::reconstructionSeconds, [&] {
+                return store_.pathTo(problem_, targetIndex_);
+            });
+        }
+
+        if (probe_.enabled()) {
+            probe_.count(&SearchStats::bytesAllocated,
+                         store_.memoryBytes() + options_.stats->peakOpenSize * sizeof(OpenEntry)
+                         + result_.path.capacity() * sizeof(State));
+        }
+    }
+
+    const Problem& problem_;
+    StateStore& store_;
+    SearchOptions options_;
+    OpenList open_;
+    SearchProbe probe_;
+    std::pmr::vector<std::pair<State, int>> successors_; // только для замера генерации
+
+    Index targetIndex_ = 0;
+    SearchStatus status_ = SearchStatus::Running;
+    SearchProgress progress_;
+    SearchResult<State> result_;
+};
+
+// Поиск целиком, за один неограниченный шаг.
+template <typename OpenList, bool Informed = false, SearchProblem Problem>
+inline auto search(const Problem& problem,
+                   StateStore& store,
+                   const SearchOptions& options = {}) -> SearchResult<typename Problem::State> {
+    SearchSession<OpenList, Informed, Problem> session(problem, store, options);
+    session.step();
+    return session.takeResult();
+}
+
+#endif
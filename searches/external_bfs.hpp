@@ -0,0 +1,297 @@
+#ifndef EXTERNAL_BFS_HPP
+#define EXTERNAL_BFS_HPP
+
+#include "../problems/jugs.hpp"
+#include "../misc/state_store.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+#include <stdlib.h>
+
+// Поиск в ширину во внешней памяти с отложенным устранением повторов.
+// Каждый слой — файл упакованных состояний (по слову на состояние),
+// отсортированный по возрастанию. Преемники слоя копятся в буфере
+// ограниченного размера, который сортируется и сбрасывается на диск
+// отдельным прогоном; затем прогоны сливаются, и потоковым слиянием с
+// отсортированным файлом всех посещённых состояний отсеиваются повторы.
+// Граф задачи ориентирован (наполнение нельзя отменить одним ходом), так что
+// повтор может найтись в любом прежнем слое, а не только в двух последних,
+// поэтому сверка идёт с полным множеством посещённых. Весь ввод-вывод
+// последовательный, память ограничена SearchOptions::externalBufferBytes.
+//
+// Путь восстанавливается обратными проходами по слоям: в слое d - 1
+// ищется состояние, из которого один ход ведёт в текущее.
+namespace external_detail {
+
+// Временный каталог для файлов поиска, удаляется вместе с содержимым.
+class TempDirectory {
+public:
+    explicit TempDirectory(const std::string& base) {
+        std::filesystem::path parent = base.empty() ? std::filesystem::temp_directory_path()
+                                                    : std::filesystem::path(base);
+        std::string pattern = (parent / "jugs-ebfs-XXXXXX").string();
+        if (!::mkdtemp(pattern.data())) {
+            throw std::runtime_error("не удалось создать временный каталог в " + parent.string());
+        }
+        path_ = pattern;
+    }
+
+    TempDirectory(const TempDirectory&) = delete;
+    auto operator=(const TempDirectory&) -> TempDirectory& = delete;
+
+    ~TempDirectory() {
+        std::error_code ignored;
+        std::filesystem::remove_all(path_, ignored);
+    }
+
+    auto file(const std::string& name) const -> std::string { return (path_ / name).string(); }
+
+private:
+    std::filesystem::path path_;
+};
+
+struct CloseFile {
+    void operator()(FILE* f) const { std::fclose(f); }
+};
+
+inline constexpr size_t kStreamBuffer = size_t{1} << 16;
+inline constexpr size_t kMaxFanIn = 64; // одновременно сливаемых прогонов
+
+inline auto openFile(const std::string& path, const char* mode) -> std::unique_ptr<FILE, CloseFile> {
+    std::unique_ptr<FILE, CloseFile> file(std::fopen(path.c_str(), mode));
+    if (!file) {
+        throw std::runtime_error("не удалось открыть " + path);
+    }
+    std::setvbuf(file.get(), nullptr, _IOFBF, kStreamBuffer);
+    return file;
+}
+
+// Последовательная запись отсортированного потока слов.
+class RunWriter {
+public:
+    explicit RunWriter(const std::string& path) : file_(openFile(path, "wb")) {}
+
+    void write(uint64_t word) {
+        if (std::fwrite(&word, sizeof(word), 1, file_.get()) != 1) {
+            throw std::runtime_error("ошибка записи файла внешнего поиска");
+        }
+        count_++;
+    }
+
+    auto count() const -> uint64_t { return count_; }
+
+private:
+    std::unique_ptr<FILE, CloseFile> file_;
+    uint64_t count_ = 0;
+};
+
+// Последовательное чтение потока слов; valid() == false в конце файла.
+class RunReader {
+public:
+    explicit RunReader(const std::string& path) : file_(openFile(path, "rb")) { advance(); }
+
+    auto valid() const -> bool { return valid_; }
+    auto current() const -> uint64_t { return current_; }
+    void advance() { valid_ = std::fread(&current_, sizeof(current_), 1, file_.get()) == 1; }
+
+private:
+    std::unique_ptr<FILE, CloseFile> file_;
+    uint64_t current_ = 0;
+    bool valid_ = false;
+};
+
+// Слияние нескольких отсортированных прогонов в один поток без повторов.
+class RunMerger {
+public:
+    explicit RunMerger(const std::vector<std::string>& paths) {
+        for (const std::string& path : paths) {
+            readers_.push_back(std::make_unique<RunReader>(path));
+            if (readers_.back()->valid()) {
+                heap_.push({readers_.back()->current(), readers_.size() - 1});
+            }
+        }
+        advance();
+    }
+
+    auto valid() const -> bool { return valid_; }
+    auto current() const -> uint64_t { return current_; }
+
+    void advance() {
+        valid_ = !heap_.empty();
+        if (!valid_) {
+            return;
+        }
+        current_ = heap_.top().first;
+        while (!heap_.empty() && heap_.top().first == current_) {
+            size_t reader = heap_.top().second;
+            heap_.pop();
+            readers_[reader]->advance();
+            if (readers_[reader]->valid()) {
+                heap_.push({readers_[reader]->current(), reader});
+            }
+        }
+    }
+
+private:
+    using Head = std::pair<uint64_t, size_t>;
+
+    std::vector<std::unique_ptr<RunReader>> readers_;
+    std::priority_queue<Head, std::vector<Head>, std::greater<>> heap_;
+    uint64_t current_ = 0;
+    bool valid_ = false;
+};
+
+// Многопроходное слияние: пока прогонов больше kMaxFanIn, группы
+// прогонов сливаются в один, чтобы не держать открытыми сотни файлов.
+inline void reduceRuns(std::vector<std::string>& runs, const TempDirectory& directory) {
+    size_t generation = 0;
+    while (runs.size() > kMaxFanIn) {
+        std::vector<std::string> merged;
+        for (size_t begin = 0; begin < runs.size(); begin += kMaxFanIn) {
+            std::vector<std::string> group(runs.begin() + begin,
+                                           runs.begin() + std::min(begin + kMaxFanIn, runs.size()));
+            merged.push_back(directory.file("merge-" + std::to_string(generation) + "-" + std::to_string(merged.size())));
+            {
+                RunWriter out(merged.back());
+                for (RunMerger in(group); in.valid(); in.advance()) {
+                    out.write(in.current());
+                }
+            }
+            for (const std::string& run : group) {
+                std::filesystem::remove(run);
+            }
+        }
+        runs = std::move(merged);
+        generation++;
+    }
+}
+
+} // namespace external_detail
+
+// Состояние задачи должно быть упаковано в одно слово (PackedState).
+inline auto externalBfs(const JugsProblem& problem,
+                        StateStore&,
+                        const SearchOptions& options = {}) -> SearchResult<JugsProblem::State> {
+    using namespace external_detail;
+    using State = JugsProblem::State;
+
+    SearchResult<State> result;
+    TempDirectory directory(options.externalDirectory);
+    auto layerPath = [&](size_t depth) { return directory.file("layer-" + std::to_string(depth)); };
+    // Файлы не перезаписываются, а создаются заново: усечение файла с данными
+    // на ext4 (auto_da_alloc) сбрасывает его на диск при закрытии.
+    auto visitedPath = [&](size_t depth) { return directory.file("visited-" + std::to_string(depth)); };
+
+    size_t bufferWords = std::max<size_t>(options.externalBufferBytes / sizeof(uint64_t), 1);
+    std::vector<uint64_t> buffer;
+    buffer.reserve(bufferWords);
+
+    State initial = problem.initial();
+    RunWriter(layerPath(0)).write(initial.word);
+    RunWriter(visitedPath(0)).write(initial.word);
+
+    std::optional<State> goal;
+    if (problem.isGoal(initial)) {
+        goal = initial;
+    }
+
+    size_t depth = 0;
+    while (!goal) {
+        // Раскрытие слоя depth: преемники в буфер, полный буфер — в прогон
+        std::vector<std::string> runs;
+        auto flush = [&] {
+            std::sort(buffer.begin(), buffer.end());
+            buffer.erase(std::unique(buffer.begin(), buffer.end()), buffer.end());
+            runs.push_back(directory.file("run-" + std::to_string(runs.size())));
+            RunWriter run(runs.back());
+            for (uint64_t word : buffer) {
+                run.write(word);
+            }
+            buffer.clear();
+        };
+        for (RunReader layer(layerPath(depth)); layer.valid(); layer.advance()) {
+            if (stopRequested(options, result.visitedNodes)) {
+                return result;
+            }
+            result.visitedNodes++;
+            problem.forEachSuccessor(State{layer.current()}, [&](const State& next, int) {
+                if (buffer.size() == bufferWords) {
+                    flush();
+                }
+                buffer.push_back(next.word);
+            });
+        }
+        if (!buffer.empty()) {
+            flush();
+        }
+        reduceRuns(runs, directory);
+
+        // Слияние прогонов с посещёнными: новые состояния — следующий слой
+        uint64_t fresh = 0;
+        {
+            RunMerger candidates(runs);
+            RunReader visited(visitedPath(depth));
+            RunWriter nextLayer(layerPath(depth + 1));
+            RunWriter nextVisited(visitedPath(depth + 1));
+            while (candidates.valid() || visited.valid()) {
+                if (!candidates.valid() || (visited.valid() && visited.current() < candidates.current())) {
+                    nextVisited.write(visited.current());
+                    visited.advance();
+                    continue;
+                }
+                uint64_t word = candidates.current();
+                if (visited.valid() && visited.current() == word) {
+                    visited.advance();
+                } else {
+                    nextLayer.write(word);
+                    if (!goal && problem.isGoal(State{word})) {
+                        goal = State{word};
+                    }
+                }
+                nextVisited.write(word);
+                candidates.advance();
+            }
+            fresh = nextLayer.count();
+        }
+        for (const std::string& run : runs) {
+            std::filesystem::remove(run);
+        }
+        std::filesystem::remove(visitedPath(depth));
+
+        depth++;
+        if (fresh == 0) {
+            return result;
+        }
+    }
+
+    // Обратные проходы: в каждом слое ищем родителя текущего состояния
+    result.pathFound = true;
+    result.path.push_back(*goal);
+    for (size_t layer = depth; layer-- > 0;) {
+        State child = result.path.back();
+        bool found = false;
+        for (RunReader reader(layerPath(layer)); reader.valid() && !found; reader.advance()) {
+            problem.forEachSuccessor(State{reader.current()}, [&](const State& next, int) {
+                found = found || next == child;
+            });
+            if (found) {
+                result.path.push_back(State{reader.current()});
+            }
+        }
+        if (!found) {
+            throw std::runtime_error("внешний BFS: не найден родитель в слое " + std::to_string(layer));
+        }
+    }
+    std::reverse(result.path.begin(), result.path.end());
+    return result;
+}
+
+#endif
@@ -0,0 +1,283 @@
+#ifndef HDA_STAR_HPP
+#define HDA_STAR_HPP
+
+#include "engine.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Параллельный A* с распределением вершин по хешу (HDA*). Каждое состояние
+// принадлежит одному потоку — по хешу плотного индекса. Поток-владелец
+// хранит открытый список своих вершин и единственный пишет их узлы в общее
+// хранилище, поэтому узлы не требуют синхронизации. Преемник чужого
+// состояния отправляется владельцу сообщением (индекс, родитель, g); сообщения
+// копятся пачками по адресатам и передаются через неблокирующие очереди
+// «много писателей — один читатель».
+//
+// Найденная цель становится рекордом (атомарный минимум g). Вершины с
+// f >= рекорда отбрасываются. Поиск завершён, когда все потоки простаивают
+// и ни одно сообщение не в пути; тогда у всех оставшихся вершин f не меньше
+// рекорда, и при допустимой эвристике рекорд оптимален.
+//
+// Завершение определяется одним счетчиком work: активный поток вносит
+// единицу, каждое отправленное, но ещё не обработанное сообщение — ещё одну.
+// Сообщение учитывается до отправки, пока отправитель активен, а поток
+// снова становится активным, только найдя сообщение у себя, — поэтому
+// work == 0 означает, что работы нет и появиться ей неоткуда.
+namespace hda_detail {
+
+struct Message {
+    StateStore::Index index;
+    StateStore::Index parent;
+    int cost;
+};
+
+struct MessageBatch {
+    std::vector<Message> messages;
+    MessageBatch* next = nullptr;
+};
+
+// Входящая очередь потока: стек Трайбера из пачек. Писатели добавляют
+// пачку CAS-ом, читатель забирает все пачки разом, поэтому ABA невозможна.
+class alignas(64) Inbox {
+public:
+    Inbox() = default;
+    Inbox(const Inbox&) = delete;
+    auto operator=(const Inbox&) -> Inbox& = delete;
+
+    ~Inbox() {
+        for (MessageBatch* batch = takeAll(); batch;) {
+            delete std::exchange(batch, batch->next);
+        }
+    }
+
+    void push(MessageBatch* batch) {
+        batch->next = head_.load(std::memory_order_relaxed);
+        while (!head_.compare_exchange_weak(batch->next, batch,
+                                            std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+
+    auto takeAll() -> MessageBatch* { return head_.exchange(nullptr, std::memory_order_acquire); }
+    auto empty() const -> bool { return head_.load(std::memory_order_relaxed) == nullptr; }
+
+private:
+    std::atomic<MessageBatch*> head_{nullptr};
+};
+
+inline constexpr size_t kBatchSize = 64;       // сообщений в пачке до отправки
+inline constexpr uint32_t kExpansionSlice = 64; // раскрытий между проверками входящих
+
+inline auto ownerOf(StateStore::Index index, unsigned threads) -> unsigned {
+    uint64_t mixed = (static_cast<uint64_t>(index) + 1) * 0x9E3779B97F4A7C15ULL;
+    return static_cast<unsigned>((mixed >> 32) % threads);
+}
+
+// Рекорд: стоимость в старших 32 битах, индекс цели в младших, чтобы
+// обновлять оба одним атомарным минимумом.
+inline constexpr uint64_t kNoIncumbent = std::numeric_limits<uint64_t>::max();
+
+inline auto incumbentCost(uint64_t packed) -> int64_t {
+    return packed == kNoIncumbent ? std::numeric_limits<int64_t>::max() : static_cast<int64_t>(packed >> 32);
+}
+
+} // namespace hda_detail
+
+template <SearchProblem Problem>
+inline auto hdaStar(const Problem& problem,
+                    StateStore& store,
+                    const SearchOptions& options = {}) -> SearchResult<typename Problem::State> {
+    using namespace hda_detail;
+    using State = typename Problem::State;
+    using Index = StateStore::Index;
+
+    unsigned threadCount = options.threads ? options.threads : std::thread::hardware_concurrency();
+    threadCount = std::max(threadCount, 1u);
+
+    std::vector<Inbox> inboxes(threadCount);
+    std::atomic<uint64_t> incumbent{kNoIncumbent};
+    std::atomic<int64_t> work{static_cast<int64_t>(threadCount)};
+    std::atomic<bool> aborted{false};
+    std::atomic<uint32_t> expanded{0};
+    std::vector<std::vector<std::pair<Index, Index>>> edges(threadCount);
+    SearchTree* tree = options.tree;
+
+    State initial = problem.initial();
+    Index startIndex = problem.indexOf(initial);
+    store.setRoot(startIndex);
+    if (tree) {
+        tree->addRoot(startIndex);
+    }
+
+    auto worker = [&](unsigned id) {
+        RadixHeapOpenList own;
+        if (ownerOf(startIndex, threadCount) == id) {
+            own.push({problem.heuristic(initial), 0, startIndex});
+        }
+        std::vector<std::vector<Message>> outgoing(threadCount);
+        uint32_t localExpanded = 0;
+
+        // Сообщение о преемнике: своё состояние обрабатывается сразу
+        auto relax = [&](Index index, Index parent, int cost) {
+            if (store.isDiscovered(index) && store.costOf(index) <= cost) {
+                return;
+            }
+            int f = addCost(cost, problem.heuristic(problem.stateOf(index)));
+            if (f >= incumbentCost(incumbent.load(std::memory_order_relaxed))) {
+                return;
+            }
+            store.setParent(index, parent, cost);
+            if (tree) {
+                edges[id].emplace_back(parent, index);
+            }
+            own.push({f, cost, index});
+        };
+
+        auto send = [&](unsigned to) {
+            auto* batch = new MessageBatch{std::move(outgoing[to])};
+            outgoing[to] = {};
+            outgoing[to].reserve(kBatchSize);
+            work.fetch_add(static_cast<int64_t>(batch->messages.size()), std::memory_order_relaxed);
+            inboxes[to].push(batch);
+        };
+
+        auto flushAll = [&] {
+            for (unsigned to = 0; to < threadCount; ++to) {
+                if (!outgoing[to].empty()) {
+                    send(to);
+                }
+            }
+        };
+
+        auto receive = [&] {
+            int64_t consumed = 0;
+            for (MessageBatch* batch = inboxes[id].takeAll(); batch;) {
+                for (const Message& message : batch->messages) {
+                    relax(message.index, message.parent, message.cost);
+                }
+                consumed += static_cast<int64_t>(batch->messages.size());
+                delete std::exchange(batch, batch->next);
+            }
+            if (consumed) {
+                work.fetch_sub(consumed, std::memory_order_acq_rel);
+            }
+        };
+
+        while (!aborted.load(std::memory_order_relaxed)) {
+            receive();
+
+            for (uint32_t slice = 0; slice < kExpansionSlice && !own.empty(); ++slice) {
+                OpenEntry current = own.pop();
+                if (store.costOf(current.index) < current.cost) {
+                    continue; // устаревшая запись
+                }
+                if (current.priority >= incumbentCost(incumbent.load(std::memory_order_relaxed))) {
+                    continue; // не лучше рекорда: отбрасываем
+                }
+                if (stopRequested(options, localExpanded)) {
+                    aborted.store(true, std::memory_order_relaxed);
+                    break;
+                }
+                localExpanded++;
+
+                State currentState = problem.stateOf(current.index);
+                if (problem.isGoal(currentState)) {
+                    uint64_t candidate = (static_cast<uint64_t>(current.cost) << 32) | current.index;
+                    uint64_t seen = incumbent.load(std::memory_order_relaxed);
+                    while (candidate < seen && !incumbent.compare_exchange_weak(seen, candidate)) {
+                    }
+                    continue;
+                }
+
+                problem.forEachSuccessor(currentState, [&](const State& nextState, int stepCost) {
+                    Index nextIndex = problem.indexOf(nextState);
+                    unsigned to = ownerOf(nextIndex, threadCount);
+                    if (to == id) {
+                        relax(nextIndex, current.index, addCost(current.cost, stepCost));
+                        return;
+                    }
+                    outgoing[to].push_back({nextIndex, current.index, addCost(current.cost, stepCost)});
+                    if (outgoing[to].size() >= kBatchSize) {
+                        send(to);
+                    }
+                });
+            }
+
+            if (!own.empty()) {
+                continue;
+            }
+
+            // Работы нет: отдать накопленное и ждать сообщений или завершения
+            flushAll();
+            if (!inboxes[id].empty()) {
+                continue;
+            }
+            work.fetch_sub(1, std::memory_order_acq_rel);
+            while (true) {
+                if (!inboxes[id].empty()) {
+                    work.fetch_add(1, std::memory_order_acq_rel);
+                    break;
+                }
+                if (work.load(std::memory_order_acquire) == 0 || aborted.load(std::memory_order_relaxed)) {
+                    expanded.fetch_add(localExpanded, std::memory_order_relaxed);
+                    return;
+                }
+                if (options.stop.stop_requested()) {
+                    aborted.store(true, std::memory_order_relaxed);
+                }
+                std::this_thread::yield();
+            }
+        }
+        expanded.fetch_add(localExpanded, std::memory_order_relaxed);
+    };
+
+    // Исключение потока (например, переполнение стоимости) останавливает
+    // остальных и передаётся вызывающему после их завершения.
+    std::mutex failureMutex;
+    std::exception_ptr failure;
+    auto guardedWorker = [&](unsigned id) {
+        try {
+            worker(id);
+        } catch (...) {
+            std::lock_guard lock(failureMutex);
+            if (!failure) {
+                failure = std::current_exception();
+            }
+            aborted.store(true, std::memory_order_relaxed);
+        }
+    };
+
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(threadCount - 1);
+        for (unsigned id = 1; id < threadCount; ++id) {
+            workers.emplace_back(guardedWorker, id);
+        }
+        guardedWorker(0);
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+
+    SearchResult<State> result;
+    result.visitedNodes = expanded.load(std::memory_order_relaxed);
+    if (tree) {
+        for (auto& threadEdges : edges) {
+            tree->edges.insert(tree->edges.end(), threadEdges.begin(), threadEdges.end());
+        }
+    }
+    uint64_t best = incumbent.load(std::memory_order_relaxed);
+    if (!aborted.load(std::memory_order_relaxed) && best != kNoIncumbent) {
+        result.pathFound = true;
+        result.path = store.pathTo(problem, static_cast<Index>(best & 0xFFFFFFFFu));
+    }
+    return result;
+}
+
+#endif
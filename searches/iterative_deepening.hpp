@@ -0,0 +1,205 @@
+#ifndef ITERATIVE_DEEPENING_HPP
+#define ITERATIVE_DEEPENING_HPP
+
+#include "engine.hpp"
+#include "../misc/instrumentation.hpp"
+#include "../misc/search_workspace.hpp"
+#include <bit>
+#include <functional>
+#include <limits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// Поиск с итеративным углублением по порогу: IDDFS — по числу ходов,
+// IDA* — по f = g + h в модели стоимости задачи. Память линейна по глубине:
+// хранится только текущий путь, его состояния (для отсечения циклов) и
+// преемники вершин пути. Хранилище состояний не используется, поэтому
+// алгоритм подходит и для конфигураций, чья сетка не помещается в память.
+//
+// Необязательная таблица транспозиций фиксированного размера
+// (SearchOptions::transpositionEntries) запоминает, с какой g состояние уже
+// встречалось на текущей итерации, и отсекает повторные заходы не с меньшей
+// g. Без неё число вершин растёт экспоненциально с глубиной.
+//
+// Когда цель недостижима, порог растёт, пока не превысит длину самого
+// длинного простого пути, — на трёх и более сосудах это практически не
+// наступает. Поэтому задача, умеющая сама определить недостижимость
+// (isSolvable, для сосудов — признак НОД), отсекается до поиска.
+template <typename P>
+concept SolvabilityAware = requires(const P& p) {
+    { p.isSolvable() } -> std::convertible_to<bool>;
+};
+
+namespace iterative_detail {
+
+template <typename State>
+class TranspositionTable {
+public:
+    TranspositionTable(size_t entries, std::pmr::memory_resource* resource)
+        : slots_(entries ? std::bit_floor(entries) : 0, resource) {}
+
+    // true, если состояние уже встречалось на этой итерации с g не больше.
+    // Иначе запоминает его с новой g (вытесняя прежнее содержимое ячейки).
+    auto seenNoWorse(const State& s, int g, uint32_t iteration) -> bool {
+        if (slots_.empty()) {
+            return false;
+        }
+        Slot& slot = slots_[std::hash<State>{}(s) & (slots_.size() - 1)];
+        if (slot.iteration == iteration && slot.state == s && slot.cost <= g) {
+            return true;
+        }
+        slot = {s, g, iteration};
+        return false;
+    }
+
+private:
+    struct Slot {
+        State state{};
+        int cost = 0;
+        uint32_t iteration = 0; // 0 — пустая ячейка
+    };
+
+    std::pmr::vector<Slot> slots_;
+};
+
+template <bool Informed, SearchProblem Problem>
+inline auto deepen(const Problem& problem,
+                   const SearchOptions& options) -> SearchResult<typename Problem::State> {
+    using State = typename Problem::State;
+
+    // IDDFS считает ходы, IDA* — стоимость с эвристикой
+    auto stepCostOf = [](int stepCost) { return Informed ? stepCost : 1; };
+    auto heuristic = [&](const State& s) { return Informed ? problem.heuristic(s) : 0; };
+
+    struct Frame {
+        State state;
+        int cost;
+        size_t begin; // преемники вершины — successors[begin, end)
+        size_t next;  // следующий необработанный
+        size_t end;
+    };
+
+    SearchResult<State> result;
+    SearchTree* tree = options.tree;
+    SearchProbe probe(options.stats);
+    std::pmr::memory_resource* resource = searchResource(options);
+    TranspositionTable<State> transpositions(options.transpositionEntries, resource);
+
+    std::pmr::vector<Frame> path(resource);
+    std::pmr::vector<std::pair<State, int>> successors(resource);
+    std::pmr::unordered_set<State> onPath(resource);
+
+    State initial = problem.initial();
+    if constexpr (SolvabilityAware<Problem>) {
+        if (!problem.isSolvable() && !problem.isGoal(initial)) {
+            return result;
+        }
+    }
+
+    size_t treeMark = 0;
+    if (tree) {
+        tree->addRoot(problem.indexOf(initial));
+        treeMark = tree->edges.size();
+    }
+
+    constexpr int unbounded = std::numeric_limits<int>::max();
+    int bound = heuristic(initial);
+
+    for (uint32_t iteration = 1; bound != unbounded; ++iteration) {
+        int nextBound = unbounded;
+        path.clear();
+        successors.clear();
+        onPath.clear();
+        if (tree) {
+            tree->edges.resize(treeMark); // дерево — только последней итерации
+        }
+
+        // Заход в вершину: проверка цели, затем преемники на вершину стека
+        auto enter = [&](const State& s, int cost) -> bool {
+            result.visitedNodes++;
+            probe.count(&SearchStats::expansions);
+            if (problem.isGoal(s)) {
+                result.pathFound = true;
+                for (const Frame& frame : path) {
+                    result.path.push_back(frame.state);
+                }
+                result.path.push_back(s);
+                return true;
+            }
+            size_t begin = successors.size();
+            problem.forEachSuccessor(s, [&](const State& next, int stepCost) {
+                successors.emplace_back(next, stepCost);
+            });
+            probe.count(&SearchStats::generated, successors.size() - begin);
+            path.push_back({s, cost, begin, begin, successors.size()});
+            onPath.insert(s);
+            return false;
+        };
+
+        transpositions.seenNoWorse(initial, 0, iteration);
+        if (enter(initial, 0)) {
+            return result;
+        }
+
+        while (!path.empty()) {
+            if (stopRequested(options, result.visitedNodes)) {
+                result.path.clear();
+                return result;
+            }
+            Frame& top = path.back();
+            if (top.next == top.end) {
+                onPath.erase(top.state);
+                successors.resize(top.begin);
+                path.pop_back();
+                continue;
+            }
+
+            auto [next, stepCost] = successors[top.next++];
+            int nextCost = addCost(top.cost, stepCostOf(stepCost));
+            State parent = top.state;
+
+            probe.count(&SearchStats::probes);
+            if (onPath.contains(next) || transpositions.seenNoWorse(next, nextCost, iteration)) {
+                probe.count(&SearchStats::duplicates);
+                continue;
+            }
+            int f = addCost(nextCost, heuristic(next));
+            if (f > bound) {
+                nextBound = std::min(nextBound, f);
+                continue;
+            }
+            if (tree) {
+                tree->addEdge(problem.indexOf(parent), problem.indexOf(next));
+            }
+            if (enter(next, nextCost)) {
+                return result;
+            }
+        }
+
+        bound = nextBound;
+    }
+
+    return result;
+}
+
+} // namespace iterative_detail
+
+// Итеративное углубление по числу ходов: кратчайший по ходам путь.
+template <SearchProblem Problem>
+inline auto iddfs(const Problem& problem,
+                  StateStore&,
+                  const SearchOptions& options = {}) -> SearchResult<typename Problem::State> {
+    return iterative_detail::deepen<false>(problem, options);
+}
+
+// IDA*: итеративное углубление по f с эвристикой задачи. При допустимой
+// эвристике путь оптимален по стоимости.
+template <SearchProblem Problem>
+inline auto idaStar(const Problem& problem,
+                    StateStore&,
+                    const SearchOptions& options = {}) -> SearchResult<typename Problem::State> {
+    return iterative_detail::deepen<true>(problem, options);
+}
+
+#endif
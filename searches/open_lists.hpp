@@ -0,0 +1,193 @@
+#ifndef OPEN_LISTS_HPP
+#define OPEN_LISTS_HPP
+
+#include "../misc/state_store.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <deque>
+#include <memory_resource>
+#include <queue>
+#include <utility>
+#include <vector>
+
+// Политики открытого списка для поискового ядра (searches/engine.hpp).
+// kBestFirst = false: вершина попадает в список один раз, при обнаружении.
+// kBestFirst = true: список упорядочен по priority, вершина может быть
+// добавлена повторно с меньшей стоимостью, устаревшие записи пропускаются.
+// Память списки берут из переданного ресурса (арены SearchWorkspace).
+
+struct OpenEntry {
+    int priority;
+    int cost;
+    StateStore::Index index;
+};
+
+struct FifoOpenList {
+    static constexpr bool kBestFirst = false;
+
+    explicit FifoOpenList(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : queue_(resource) {}
+
+    auto empty() const -> bool { return queue_.empty(); }
+    auto size() const -> size_t { return queue_.size(); }
+    void push(const OpenEntry& e) { queue_.push_back(e); }
+    auto pop() -> OpenEntry {
+        OpenEntry e = queue_.front();
+        queue_.pop_front();
+        return e;
+    }
+
+private:
+    std::pmr::deque<OpenEntry> queue_;
+};
+
+struct LifoOpenList {
+    static constexpr bool kBestFirst = false;
+
+    explicit LifoOpenList(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : stack_(resource) {}
+
+    auto empty() const -> bool { return stack_.empty(); }
+    auto size() const -> size_t { return stack_.size(); }
+    void push(const OpenEntry& e) { stack_.push_back(e); }
+    auto pop() -> OpenEntry {
+        OpenEntry e = stack_.back();
+        stack_.pop_back();
+        return e;
+    }
+
+private:
+    std::pmr::vector<OpenEntry> stack_;
+};
+
+struct ComparePriority {
+    bool operator()(const OpenEntry& a, const OpenEntry& b) const {
+        return a.priority > b.priority;
+    }
+};
+
+struct BinaryHeapOpenList {
+    static constexpr bool kBestFirst = true;
+
+    explicit BinaryHeapOpenList(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : heap_(std::pmr::polymorphic_allocator<OpenEntry>(resource)) {}
+
+    auto empty() const -> bool { return heap_.empty(); }
+    auto size() const -> size_t { return heap_.size(); }
+    void push(const OpenEntry& e) { heap_.push(e); }
+    auto pop() -> OpenEntry {
+        OpenEntry e = heap_.top();
+        heap_.pop();
+        return e;
+    }
+
+private:
+    std::priority_queue<OpenEntry, std::pmr::vector<OpenEntry>, ComparePriority> heap_;
+};
+
+// Радиксная куча для целых неотрицательных priority, снимаемых почти
+// по неубыванию (UCS, A* с монотонной эвристикой). Корзина k > 0 хранит
+// записи, у которых старший бит, отличающий priority от последнего
+// снятого, — (k-1)-й; корзина 0 — записи с priority не больше последнего
+// снятого. Когда корзина 0 пуста, минимум ищется в первой непустой корзине
+// и её записи раскладываются по младшим; запись переезжает не больше 32
+// раз, поэтому pop — амортизированное O(log C) от разброса стоимостей, а
+// память пропорциональна числу записей, а не величине f.
+//
+// Корзина 0 упорядочена по (priority, -cost), лучшая запись в конце:
+// среди записей с равным f первой снимается самая глубокая, при полном
+// равенстве — добавленная последней. При монотонной эвристике новые записи
+// корзины 0 не хуже уже лежащих там, и она остаётся стеком с O(1) на
+// операцию. Иначе (немонотонная эвристика, сообщения HDA*) корзина 0 до
+// опустошения становится двоичной кучей.
+struct RadixHeapOpenList {
+    static constexpr bool kBestFirst = true;
+
+    explicit RadixHeapOpenList(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : buckets_(kBuckets, resource) {}
+
+    auto empty() const -> bool { return size_ == 0; }
+    auto size() const -> size_t { return size_; }
+
+    void push(const OpenEntry& e) {
+        uint32_t key = keyOf(e);
+        if (key <= last_) {
+            pushTop(e);
+        } else {
+            buckets_[std::bit_width(key ^ last_)].push_back(e);
+        }
+        size_++;
+    }
+
+    auto pop() -> OpenEntry {
+        std::pmr::vector<OpenEntry>& top = buckets_[0];
+        if (top.empty()) {
+            redistribute();
+        }
+        if (heapOrdered_) {
+            std::pop_heap(top.begin(), top.end(), Worse{});
+        }
+        OpenEntry e = top.back();
+        top.pop_back();
+        heapOrdered_ = heapOrdered_ && !top.empty();
+        size_--;
+        return e;
+    }
+
+private:
+    static constexpr size_t kBuckets = 33;
+
+    struct Worse {
+        bool operator()(const OpenEntry& a, const OpenEntry& b) const {
+            return a.priority != b.priority ? a.priority > b.priority : a.cost < b.cost;
+        }
+    };
+
+    static auto keyOf(const OpenEntry& e) -> uint32_t { return static_cast<uint32_t>(e.priority); }
+
+    void pushTop(const OpenEntry& e) {
+        std::pmr::vector<OpenEntry>& top = buckets_[0];
+        bool inOrder = top.empty() || !Worse{}(e, top.back());
+        top.push_back(e);
+        if (heapOrdered_) {
+            std::push_heap(top.begin(), top.end(), Worse{});
+        } else if (!inOrder) {
+            std::make_heap(top.begin(), top.end(), Worse{});
+            heapOrdered_ = true;
+        }
+    }
+
+    // Корзина 0 пуста: новый минимум — наименьший priority первой непустой
+    // корзины, её записи переходят в младшие корзины.
+    void redistribute() {
+        size_t k = 1;
+        while (buckets_[k].empty()) {
+            k++;
+        }
+        std::pmr::vector<OpenEntry>& bucket = buckets_[k];
+        last_ = keyOf(*std::min_element(bucket.begin(), bucket.end(), [](const OpenEntry& a, const OpenEntry& b) {
+            return a.priority < b.priority;
+        }));
+        std::pmr::vector<OpenEntry>& top = buckets_[0];
+        for (const OpenEntry& e : bucket) {
+            uint32_t key = keyOf(e);
+            if (key == last_) {
+                top.push_back(e);
+            } else {
+                buckets_[std::bit_width(key ^ last_)].push_back(e);
+            }
+        }
+        bucket.clear();
+        if (!std::is_sorted(top.begin(), top.end(), Worse{})) {
+            std::stable_sort(top.begin(), top.end(), Worse{});
+        }
+    }
+
+    std::pmr::vector<std::pmr::vector<OpenEntry>> buckets_;
+    uint32_t last_ = 0;
+    bool heapOrdered_ = false;
+    size_t size_ = 0;
+};
+
+#endif
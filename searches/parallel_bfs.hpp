@@ -0,0 +1,169 @@
+#ifndef PARALLEL_BFS_HPP
+#define PARALLEL_BFS_HPP
+
+#include "engine.hpp"
+#include "../misc/atomic_bitset.hpp"
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <bit>
+#include <limits>
+#include <thread>
+#include <utility>
+
+// Поуровневый параллельный поиск в ширину. Текущий и следующий фронты,
+// а также множество посещённых — атомарные битовые множества над плотным
+// индексом. Слова текущего фронта раздаются потокам порциями; состояние
+// достаётся тому потоку, чей fetch_or первым выставил бит посещения, и
+// только он записывает родителя в хранилище, поэтому гонок за узлы нет.
+// Цель проверяется при обнаружении: все цели уровня d+1 находятся во время
+// раскрытия уровня d, так что длина пути совпадает с последовательным bfs.
+template <SearchProblem Problem>
+inline auto parallelBfs(const Problem& problem,
+                        StateStore& store,
+                        const SearchOptions& options = {}) -> SearchResult<typename Problem::State> {
+
+    using State = typename Problem::State;
+    using Index = StateStore::Index;
+    using Edge = std::pair<Index, Index>;
+
+    constexpr Index noGoal = std::numeric_limits<Index>::max();
+    constexpr size_t chunkWords = 64;
+
+    unsigned threadCount = options.threads ? options.threads : std::thread::hardware_concurrency();
+    threadCount = std::max(threadCount, 1u);
+
+    AtomicBitset visited(problem.stateCount());
+    AtomicBitset current(problem.stateCount());
+    AtomicBitset next(problem.stateCount());
+    AtomicBitset* currentFrontier = &current;
+    AtomicBitset* nextFrontier = &next;
+
+    SearchTree* tree = options.tree;
+    SearchResult<State> result;
+
+    State initial = problem.initial();
+    Index startIndex = problem.indexOf(initial);
+    store.setRoot(startIndex);
+    if (tree) {
+        tree->addRoot(startIndex);
+    }
+    visited.set(startIndex);
+    current.set(startIndex);
+
+    if (problem.isGoal(initial)) {
+        result.pathFound = true;
+        result.visitedNodes = 1;
+        result.path = store.pathTo(problem, startIndex);
+        return result;
+    }
+
+    std::atomic<Index> goalIndex{noGoal};
+    std::atomic<size_t> nextWord{0};
+    std::atomic<bool> nextNonEmpty{false};
+    std::atomic<uint32_t> expanded{0};
+    int depth = 0;
+    bool done = false;
+
+    // Рёбра дерева перебора каждый поток копит у себя и сливает после уровня.
+    std::vector<std::vector<Edge>> edges(threadCount);
+
+    auto expandLevel = [&](unsigned id) {
+        uint32_t localExpanded = 0;
+        bool localNonEmpty = false;
+        int nextCost = depth + 1;
+        size_t words = currentFrontier->wordCount();
+
+        while (goalIndex.load(std::memory_order_relaxed) == noGoal && !options.stop.stop_requested()) {
+            size_t begin = nextWord.fetch_add(chunkWords, std::memory_order_relaxed);
+            if (begin >= words) {
+                break;
+            }
+            size_t end = std::min(begin + chunkWords, words);
+            for (size_t w = begin; w < end; ++w) {
+                uint64_t bits = currentFrontier->takeWord(w);
+                while (bits) {
+                    Index currentIndex = static_cast<Index>(w * 64 + std::countr_zero(bits));
+                    bits &= bits - 1;
+                    localExpanded++;
+
+                    problem.forEachSuccessor(problem.stateOf(currentIndex), [&](const State& nextState, int) {
+                        Index nextIndex = problem.indexOf(nextState);
+                        if (!visited.testAndSet(nextIndex)) {
+                            return;
+                        }
+                        store.setParent(nextIndex, currentIndex, nextCost);
+                        if (tree) {
+                            edges[id].emplace_back(currentIndex, nextIndex);
+                        }
+                        nextFrontier->set(nextIndex);
+                        localNonEmpty = true;
+                        if (problem.isGoal(nextState)) {
+                            Index none = noGoal;
+                            goalIndex.compare_exchange_strong(none, nextIndex, std::memory_order_relaxed);
+                        }
+                    });
+                }
+            }
+        }
+
+        expanded.fetch_add(localExpanded, std::memory_order_relaxed);
+        if (localNonEmpty) {
+            nextNonEmpty.store(true, std::memory_order_relaxed);
+        }
+    };
+
+    std::barrier levelSync(threadCount);
+
+    auto worker = [&](unsigned id) {
+        while (true) {
+            levelSync.arrive_and_wait();
+            if (done) {
+                return;
+            }
+            expandLevel(id);
+            levelSync.arrive_and_wait();
+        }
+    };
+
+    std::vector<std::jthread> workers;
+    workers.reserve(threadCount - 1);
+    for (unsigned id = 1; id < threadCount; ++id) {
+        workers.emplace_back(worker, id);
+    }
+
+    while (!done) {
+        nextWord.store(0, std::memory_order_relaxed);
+        nextNonEmpty.store(false, std::memory_order_relaxed);
+
+        levelSync.arrive_and_wait();
+        expandLevel(0);
+        levelSync.arrive_and_wait();
+
+        if (tree) {
+            for (auto& threadEdges : edges) {
+                tree->edges.insert(tree->edges.end(), threadEdges.begin(), threadEdges.end());
+                threadEdges.clear();
+            }
+        }
+
+        depth++;
+        std::swap(currentFrontier, nextFrontier);
+        done = goalIndex.load(std::memory_order_relaxed) != noGoal
+               || !nextNonEmpty.load(std::memory_order_relaxed)
+               || options.stop.stop_requested();
+    }
+    // Отпускаем рабочих, ожидающих начала следующего уровня.
+    levelSync.arrive_and_wait();
+
+    result.visitedNodes = expanded.load(std::memory_order_relaxed);
+    Index found = goalIndex.load(std::memory_order_relaxed);
+    if (found != noGoal) {
+        result.pathFound = true;
+        result.path = store.pathTo(problem, found);
+    }
+
+    return result;
+}
+
+#endif
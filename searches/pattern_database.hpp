@@ -0,0 +1,446 @@
+#ifndef PATTERN_DATABASE_HPP
+#define PATTERN_DATABASE_HPP
+
+#include "../problems/jugs.hpp"
+#include "../misc/mapped_file.hpp"
+#include "../misc/state_store.hpp"
+#include "engine.hpp"
+#include "open_lists.hpp"
+#include "astar.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// База шаблонов для A* в задаче о сосудах. Шаблон — подмножество сосудов;
+// абстракция забывает объёмы остальных, и переливание с сосудом вне
+// шаблона превращается в ход, переливающий любой допустимый объём. Каждый
+// конкретный ход отображается в абстрактный той же стоимости, поэтому
+// абстрактные расстояния — монотонная нижняя оценка конкретных.
+//
+// Цель «в каком-то сосуде ровно t» — дизъюнкция, и абстракция, не видящая
+// часть сосудов, считала бы её всегда достижимой. Поэтому для каждого сосуда
+// i шаблона хранится расстояние до «в i ровно t», а оценка — минимум по
+// сосудам максимума по шаблонам, содержащим сосуд. Минимум и максимум
+// монотонных оценок монотонны.
+//
+// Таблицы строятся один раз на конфигурацию сосудов, модель стоимости и
+// набор целей обратным поиском от абстрактных целей (утилита pdb_build),
+// хранятся по байту на абстрактное состояние (расстояния от 255 хранятся
+// как 255) и загружаются через mmap.
+
+namespace pattern_detail {
+
+inline constexpr char kMagic[8] = {'J', 'U', 'G', 'S', 'P', 'D', 'B', '1'};
+inline constexpr uint32_t kVersion = 1;
+inline constexpr int kSaturated = std::numeric_limits<uint8_t>::max();
+
+// Заголовок файла. За ним: int32 емкости[jugCount], uint64 маски
+// шаблонов[patternCount], int32 цели[targetCount], выравнивание до 8 байт и
+// таблицы в порядке [шаблон][цель][сосуд шаблона][абстрактное состояние].
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t jugCount;
+    uint32_t patternCount;
+    uint32_t targetCount;
+    int32_t costs[4];
+    uint64_t tableBytes;
+};
+
+inline auto metadataBytes(size_t jugs, size_t patterns, size_t targets) -> size_t {
+    size_t bytes = sizeof(Header) + jugs * sizeof(int32_t) + patterns * sizeof(uint64_t)
+                   + targets * sizeof(int32_t);
+    return (bytes + 7) & ~size_t{7};
+}
+
+// Проекция состояния на сосуды шаблона: смешанная система счисления,
+// последний сосуд шаблона — младший разряд.
+struct Projection {
+    std::vector<size_t> jugs;
+    std::vector<size_t> strides;
+    size_t size = 1;
+
+    auto indexOf(const JugsProblem& problem, JugsProblem::State s) const -> size_t {
+        size_t index = 0;
+        for (size_t k = 0; k < jugs.size(); ++k) {
+            index += static_cast<size_t>(problem.volume(s, jugs[k])) * strides[k];
+        }
+        return index;
+    }
+};
+
+inline auto makeProjection(const std::vector<int>& capacities, uint64_t mask) -> Projection {
+    Projection projection;
+    for (size_t jug = 0; jug < capacities.size(); ++jug) {
+        if (mask >> jug & 1) {
+            projection.jugs.push_back(jug);
+        }
+    }
+    if (projection.jugs.empty() || (capacities.size() < 64 && mask >> capacities.size())) {
+        throw std::invalid_argument("шаблон должен состоять из существующих сосудов");
+    }
+    projection.strides.resize(projection.jugs.size());
+    for (size_t k = projection.jugs.size(); k-- > 0;) {
+        projection.strides[k] = projection.size;
+        projection.size *= static_cast<size_t>(capacities[projection.jugs[k]]) + 1;
+        if (projection.size >= UINT32_MAX) {
+            throw std::length_error("абстрактное пространство шаблона не помещается в 32-битный индекс");
+        }
+    }
+    return projection;
+}
+
+// Абстрактные ходы из состояния с объёмами volumes (по сосудам шаблона).
+// Сосуды вне шаблона неизвестны: в них можно перелить от 0 до
+// min(v, наибольшая внешняя емкость) и получить из них от 0 до
+// min(наибольшая внешняя емкость, свободное место). Ходы, не меняющие
+// абстрактного состояния, пропускаются.
+template <typename Visit>
+void forEachAbstractSuccessor(const std::vector<int>& capacities,
+                              const MoveCosts& costs,
+                              const Projection& projection,
+                              const std::vector<int>& volumes,
+                              Visit&& visit) {
+    size_t width = projection.jugs.size();
+    int outsideCapacity = 0;
+    for (size_t jug = 0; jug < capacities.size(); ++jug) {
+        if (std::find(projection.jugs.begin(), projection.jugs.end(), jug) == projection.jugs.end()) {
+            outsideCapacity = std::max(outsideCapacity, capacities[jug]);
+        }
+    }
+
+    size_t index = 0;
+    for (size_t k = 0; k < width; ++k) {
+        index += static_cast<size_t>(volumes[k]) * projection.strides[k];
+    }
+    auto shifted = [&](size_t k, int delta) {
+        return static_cast<size_t>(static_cast<int64_t>(index) + delta * static_cast<int64_t>(projection.strides[k]));
+    };
+
+    for (size_t k = 0; k < width; ++k) {
+        int capacity = capacities[projection.jugs[k]];
+        int v = volumes[k];
+        if (v < capacity) {
+            visit(shifted(k, capacity - v), costs.fill + costs.perLiter * (capacity - v));
+        }
+        if (v > 0) {
+            visit(shifted(k, -v), costs.empty + costs.perLiter * v);
+        }
+        for (size_t l = 0; l < width; ++l) {
+            int transfer = std::min(v, capacities[projection.jugs[l]] - volumes[l]);
+            if (l != k && transfer > 0) {
+                visit(shifted(l, transfer) - transfer * projection.strides[k],
+                      costs.pour + costs.perLiter * transfer);
+            }
+        }
+        for (int x = 1; x <= std::min(v, outsideCapacity); ++x) {
+            visit(shifted(k, -x), costs.pour + costs.perLiter * x);
+        }
+        for (int x = 1; x <= std::min(outsideCapacity, capacity - v); ++x) {
+            visit(shifted(k, x), costs.pour + costs.perLiter * x);
+        }
+    }
+}
+
+// Таблицы одного шаблона для всех целей: обратный граф абстракции в
+// формате CSR и обратный Дейкстра от каждой абстрактной цели «в сосуде k
+// ровно t». Поиск обрезается на kSaturated — большие значения не хранятся.
+inline void writePatternTables(std::ostream& out,
+                               const std::vector<int>& capacities,
+                               const MoveCosts& costs,
+                               const Projection& projection,
+                               const std::vector<int>& targets) {
+    using Index = StateStore::Index;
+    size_t width = projection.jugs.size();
+    size_t size = projection.size;
+
+    auto volumesOf = [&](size_t index, std::vector<int>& volumes) {
+        for (size_t k = 0; k < width; ++k) {
+            volumes[k] = static_cast<int>(index / projection.strides[k]);
+            index %= projection.strides[k];
+        }
+    };
+
+    struct ReverseEdge {
+        Index source;
+        int cost;
+    };
+    std::vector<size_t> offsets(size + 1, 0);
+    std::vector<int> volumes(width);
+    for (size_t index = 0; index < size; ++index) {
+        volumesOf(index, volumes);
+        forEachAbstractSuccessor(capacities, costs, projection, volumes, [&](size_t next, int) {
+            offsets[next + 1]++;
+        });
+    }
+    for (size_t index = 0; index < size; ++index) {
+        offsets[index + 1] += offsets[index];
+    }
+    std::vector<ReverseEdge> edges(offsets[size]);
+    std::vector<size_t> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t index = 0; index < size; ++index) {
+        volumesOf(index, volumes);
+        forEachAbstractSuccessor(capacities, costs, projection, volumes, [&](size_t next, int cost) {
+            edges[fill[next]++] = {static_cast<Index>(index), cost};
+        });
+    }
+
+    std::vector<int> distance(size);
+    std::vector<uint8_t> table(size);
+    for (int target : targets) {
+        for (size_t k = 0; k < width; ++k) {
+            std::fill(distance.begin(), distance.end(), kSaturated);
+            RadixHeapOpenList open;
+            if (target >= 0 && target <= capacities[projection.jugs[k]]) {
+                for (size_t index = 0; index < size; ++index) {
+                    if (static_cast<int>(index / projection.strides[k] % (capacities[projection.jugs[k]] + 1)) == target) {
+                        distance[index] = 0;
+                        open.push({0, 0, static_cast<Index>(index)});
+                    }
+                }
+            }
+            while (!open.empty()) {
+                OpenEntry current = open.pop();
+                if (distance[current.index] < current.cost) {
+                    continue;
+                }
+                for (size_t e = offsets[current.index]; e < offsets[current.index + 1]; ++e) {
+                    int nextCost = addCost(current.cost, edges[e].cost);
+                    if (nextCost < distance[edges[e].source]) {
+                        distance[edges[e].source] = nextCost;
+                        open.push({nextCost, nextCost, edges[e].source});
+                    }
+                }
+            }
+            std::transform(distance.begin(), distance.end(), table.begin(),
+                           [](int d) { return static_cast<uint8_t>(d); });
+            out.write(reinterpret_cast<const char*>(table.data()), static_cast<std::streamsize>(size));
+        }
+    }
+}
+
+} // namespace pattern_detail
+
+// Строит базу шаблонов и пишет её в out. Каждый шаблон — битовая маска
+// сосудов; targets — цели, для которых база будет применима.
+inline void buildPatternDatabase(std::ostream& out,
+                                 const std::vector<int>& capacities,
+                                 const MoveCosts& costs,
+                                 const std::vector<uint64_t>& patterns,
+                                 const std::vector<int>& targets) {
+    using namespace pattern_detail;
+
+    JugsProblem validated(capacities, 0, costs); // проверка емкостей и стоимостей
+    if (patterns.empty() || targets.empty()) {
+        throw std::invalid_argument("нужны хотя бы один шаблон и одна цель");
+    }
+
+    std::vector<Projection> projections;
+    uint64_t tableBytes = 0;
+    for (uint64_t mask : patterns) {
+        projections.push_back(makeProjection(capacities, mask));
+        tableBytes += projections.back().size * projections.back().jugs.size() * targets.size();
+    }
+
+    Header header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.jugCount = static_cast<uint32_t>(capacities.size());
+    header.patternCount = static_cast<uint32_t>(patterns.size());
+    header.targetCount = static_cast<uint32_t>(targets.size());
+    header.costs[0] = costs.fill;
+    header.costs[1] = costs.empty;
+    header.costs[2] = costs.pour;
+    header.costs[3] = costs.perLiter;
+    header.tableBytes = tableBytes;
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (int capacity : capacities) {
+        int32_t value = capacity;
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+    out.write(reinterpret_cast<const char*>(patterns.data()),
+              static_cast<std::streamsize>(patterns.size() * sizeof(uint64_t)));
+    for (int target : targets) {
+        int32_t value = target;
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+    size_t written = sizeof(header) + capacities.size() * sizeof(int32_t)
+                     + patterns.size() * sizeof(uint64_t) + targets.size() * sizeof(int32_t);
+    for (; written < metadataBytes(capacities.size(), patterns.size(), targets.size()); ++written) {
+        out.put('\0');
+    }
+
+    for (const Projection& projection : projections) {
+        writePatternTables(out, capacities, costs, projection, targets);
+    }
+    if (!out) {
+        throw std::runtime_error("не удалось записать базу шаблонов");
+    }
+}
+
+// База шаблонов, отображённая в память. Конструктор проверяет заголовок
+// и размер файла; таблицы читаются прямо из отображения.
+class PatternDatabase {
+public:
+    explicit PatternDatabase(const std::string& path) : file_(path) {
+        using namespace pattern_detail;
+
+        const std::byte* data = file_.data();
+        if (file_.size() < sizeof(Header)) {
+            throw std::runtime_error(path + ": файл слишком мал для базы шаблонов");
+        }
+        Header header;
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion) {
+            throw std::runtime_error(path + ": не база шаблонов или неподдерживаемая версия");
+        }
+        size_t metadata = metadataBytes(header.jugCount, header.patternCount, header.targetCount);
+        if (file_.size() < metadata || file_.size() - metadata != header.tableBytes) {
+            throw std::runtime_error(path + ": размер файла не совпадает с заголовком");
+        }
+
+        const std::byte* cursor = data + sizeof(Header);
+        capacities_.resize(header.jugCount);
+        for (int& capacity : capacities_) {
+            int32_t value;
+            std::memcpy(&value, cursor, sizeof(value));
+            capacity = value;
+            cursor += sizeof(value);
+        }
+        costs_ = {header.costs[0], header.costs[1], header.costs[2], header.costs[3]};
+
+        uint64_t expectedBytes = 0;
+        for (uint32_t p = 0; p < header.patternCount; ++p) {
+            uint64_t mask;
+            std::memcpy(&mask, cursor, sizeof(mask));
+            cursor += sizeof(mask);
+            projections_.push_back(makeProjection(capacities_, mask));
+            expectedBytes += projections_.back().size * projections_.back().jugs.size() * header.targetCount;
+        }
+        if (expectedBytes != header.tableBytes) {
+            throw std::runtime_error(path + ": размер таблиц не совпадает с шаблонами");
+        }
+
+        targets_.resize(header.targetCount);
+        for (int& target : targets_) {
+            int32_t value;
+            std::memcpy(&value, cursor, sizeof(value));
+            target = value;
+            cursor += sizeof(value);
+        }
+
+        tables_ = reinterpret_cast<const uint8_t*>(data + metadata);
+    }
+
+    auto capacities() const -> const std::vector<int>& { return capacities_; }
+    auto costs() const -> const MoveCosts& { return costs_; }
+    auto targets() const -> const std::vector<int>& { return targets_; }
+    auto patternCount() const -> size_t { return projections_.size(); }
+
+    // Применима ли база к задаче: те же сосуды, стоимости и цель из набора.
+    auto matches(const JugsProblem& problem) const -> bool {
+        const MoveCosts& c = problem.costs();
+        return problem.capacities() == capacities_
+               && c.fill == costs_.fill && c.empty == costs_.empty
+               && c.pour == costs_.pour && c.perLiter == costs_.perLiter
+               && std::find(targets_.begin(), targets_.end(), problem.targetVolume()) != targets_.end();
+    }
+
+    // Таблица «расстояние до цели target в k-м сосуде шаблона pattern».
+    auto table(size_t pattern, size_t targetSlot, size_t k) const -> const uint8_t* {
+        const uint8_t* base = tables_;
+        for (size_t p = 0; p < pattern; ++p) {
+            base += projections_[p].size * projections_[p].jugs.size() * targets_.size();
+        }
+        const pattern_detail::Projection& projection = projections_[pattern];
+        return base + (targetSlot * projection.jugs.size() + k) * projection.size;
+    }
+
+    auto projection(size_t pattern) const -> const pattern_detail::Projection& { return projections_[pattern]; }
+
+    auto targetSlot(int target) const -> size_t {
+        return static_cast<size_t>(std::find(targets_.begin(), targets_.end(), target) - targets_.begin());
+    }
+
+private:
+    MappedFile file_;
+    std::vector<int> capacities_;
+    MoveCosts costs_;
+    std::vector<pattern_detail::Projection> projections_;
+    std::vector<int> targets_;
+    const uint8_t* tables_ = nullptr;
+};
+
+// Задача о сосудах с эвристикой из базы шаблонов: все ходы и нумерация —
+// исходной задачи, оценка — максимум из её собственной и оценки по базе.
+class PatternHeuristicProblem {
+public:
+    using State = JugsProblem::State;
+    using Index = JugsProblem::Index;
+
+    PatternHeuristicProblem(const JugsProblem& problem, const PatternDatabase& database)
+        : problem_(problem), lookupsByJug_(problem.jugCount()) {
+        size_t slot = database.targetSlot(problem.targetVolume());
+        for (size_t p = 0; p < database.patternCount(); ++p) {
+            const auto& projection = database.projection(p);
+            for (size_t k = 0; k < projection.jugs.size(); ++k) {
+                lookupsByJug_[projection.jugs[k]].push_back({&projection, database.table(p, slot, k)});
+            }
+        }
+    }
+
+    auto initial() const -> State { return problem_.initial(); }
+    auto isGoal(State s) const -> bool { return problem_.isGoal(s); }
+
+    template <typename Visit>
+    void forEachSuccessor(State s, Visit&& visit) const {
+        problem_.forEachSuccessor(s, std::forward<Visit>(visit));
+    }
+
+    auto heuristic(State s) const -> int {
+        int best = std::numeric_limits<int>::max();
+        for (const auto& lookups : lookupsByJug_) {
+            int bound = 0;
+            for (const Lookup& lookup : lookups) {
+                bound = std::max<int>(bound, lookup.table[lookup.projection->indexOf(problem_, s)]);
+            }
+            best = std::min(best, bound);
+        }
+        return std::max(best, problem_.heuristic(s));
+    }
+
+    auto stateCount() const -> size_t { return problem_.stateCount(); }
+    auto indexOf(State s) const -> Index { return problem_.indexOf(s); }
+    auto stateOf(Index index) const -> State { return problem_.stateOf(index); }
+    void print(std::ostream& out, State s) const { problem_.print(out, s); }
+
+private:
+    struct Lookup {
+        const pattern_detail::Projection* projection;
+        const uint8_t* table;
+    };
+
+    const JugsProblem& problem_;
+    std::vector<std::vector<Lookup>> lookupsByJug_;
+};
+
+// A* с оценкой по базе шаблонов из options.patterns. Если база не загружена
+// или не подходит к задаче, работает как обычный A*.
+inline auto astarPdb(const JugsProblem& problem,
+                     StateStore& store,
+                     const SearchOptions& options = {}) -> SearchResult<JugsProblem::State> {
+    if (!options.patterns || !options.patterns->matches(problem)) {
+        return astar(problem, store, options);
+    }
+    PatternHeuristicProblem informed(problem, *options.patterns);
+    return search<RadixHeapOpenList, true>(informed, store, options);
+}
+
+#endif
@@ -0,0 +1,114 @@
+#ifndef PORTFOLIO_HPP
+#define PORTFOLIO_HPP
+
+#include "engine.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Портфель алгоритмов: все выбранные поиски запускаются одновременно, каждый
+// в своём потоке и со своим хранилищем. Первый завершившийся поиск побеждает
+// (требование к качеству ответа задаётся набором алгоритмов), остальным через
+// общий stop_token отправляется запрос остановки, и портфель дожидается их
+// выхода. Так на каждом экземпляре задачи время ответа — лучшее из
+// алгоритмов портфеля, ценой занятых ядер.
+//
+// Ответ «пути нет» от поиска, остановленного не портфелем, тоже окончателен:
+// все поиски полны на конечном пространстве состояний.
+//
+// Исключение поиска (нет каталога внешнего BFS, не хватило памяти) не
+// выходит из его потока: такой поиск считается завершённым без ответа, а
+// остальные продолжают. Только если упали все, runPortfolio бросает
+// исключение первого упавшего.
+
+template <SearchProblem Problem>
+struct PortfolioEntry {
+    AlgorithmFunction<Problem> function;
+    std::string name;
+};
+
+template <typename State>
+struct PortfolioResult {
+    SearchResult<State> result;
+    std::string algorithm; // победитель; пусто, если портфель отменен извне
+    double seconds = 0;    // от запуска портфеля до ответа победителя
+};
+
+template <SearchProblem Problem>
+inline auto runPortfolio(const Problem& problem,
+                         const std::vector<PortfolioEntry<Problem>>& entries,
+                         const SearchOptions& options = {}) -> PortfolioResult<typename Problem::State> {
+    using State = typename Problem::State;
+
+    std::stop_source stop;
+    // Внешняя отмена (например, портфель внутри отменяемого запроса)
+    std::stop_callback forward(options.stop, [&] { stop.request_stop(); });
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::optional<PortfolioResult<State>> winner;
+    size_t running = entries.size();
+    std::vector<std::exception_ptr> failures;
+    auto startTime = std::chrono::steady_clock::now();
+
+    auto run = [&](const PortfolioEntry<Problem>& entry) {
+        // Дерево, статистика и рабочее пространство не делятся между потоками
+        SearchOptions own = options;
+        own.stop = stop.get_token();
+        own.tree = nullptr;
+        own.stats = nullptr;
+        own.workspace = nullptr;
+
+        SearchResult<State> result;
+        std::exception_ptr error;
+        try {
+            StateStore store(problem.stateCount());
+            result = entry.function(problem, store, own);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        auto endTime = std::chrono::steady_clock::now();
+
+        std::lock_guard lock(mutex);
+        running--;
+        // Упавший поиск завершён, но не побеждает
+        if (error) {
+            failures.push_back(error);
+            finished.notify_one();
+            return;
+        }
+        // Результат остановленного поиска неполон — его не берем
+        if (!winner && !stop.stop_requested()) {
+            winner.emplace(PortfolioResult<State>{std::move(result), entry.name,
+                                                  std::chrono::duration<double>(endTime - startTime).count()});
+            stop.request_stop();
+        }
+        finished.notify_one();
+    };
+
+    {
+        std::vector<std::jthread> threads;
+        threads.reserve(entries.size());
+        for (const PortfolioEntry<Problem>& entry : entries) {
+            threads.emplace_back(run, std::cref(entry));
+        }
+
+        std::unique_lock lock(mutex);
+        finished.wait(lock, [&] { return winner || running == 0; });
+        lock.unlock();
+        stop.request_stop();
+    } // потоки проигравших завершаются здесь
+
+    if (!winner && !entries.empty() && failures.size() == entries.size()) {
+        std::rethrow_exception(failures.front());
+    }
+    return winner ? std::move(*winner) : PortfolioResult<State>{};
+}
+
+#endif
@@ -0,0 +1,364 @@
+#ifndef SOLUTION_CACHE_HPP
+#define SOLUTION_CACHE_HPP
+
+#include "../problems/jugs.hpp"
+#include "../misc/mapped_file.hpp"
+#include "../misc/state_store.hpp"
+#include "volume_table.hpp"
+#include "bfs.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <list>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+
+// Постоянный кэш решений по конфигурации сосудов. Для каждой конфигурации
+// на диске хранится полная таблица обхода в ширину от начального состояния:
+// родитель и число ходов для каждого состояния плюс первое (ближайшее)
+// состояние с каждым объёмом. Ответ на любую цель — отображение файла в
+// память и проход по цепочке родителей, без поиска. Путь совпадает по
+// длине с bfs; модель стоимости ходов в ключ не входит.
+//
+// Целостность: заголовок и индекс объёмов защищены контрольной суммой,
+// размер файла сверяется с заголовком, а каждый проход по цепочке проверяет,
+// что индексы в пределах таблицы и глубина убывает ровно на 1. Повреждённая
+// запись удаляется и строится заново. Полную сумму таблицы можно проверить
+// при открытии (CacheLimits::verifyPayload), это читает весь файл.
+//
+// Ограничения: суммарный размер файлов и их число. Порядок вытеснения —
+// по времени последнего обращения (mtime файла обновляется при каждом
+// чтении), поэтому LRU общий для всех процессов, использующих каталог.
+struct CacheLimits {
+    uint64_t maxBytes = uint64_t{1} << 30;
+    size_t maxEntries = 64;
+    bool verifyPayload = false;
+};
+
+namespace cache_detail {
+
+inline constexpr char kMagic[8] = {'J', 'U', 'G', 'S', 'B', 'F', 'S', '1'};
+inline constexpr uint32_t kVersion = 1;
+inline constexpr uint32_t kNone = std::numeric_limits<uint32_t>::max();
+
+// Заголовок файла. За ним: int32 емкости[jugCount], uint32 первое
+// состояние[volumeCount], выравнивание до 8 байт и Node[stateCount].
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t jugCount;
+    uint64_t stateCount;
+    uint32_t volumeCount;
+    uint32_t initialIndex;
+    uint64_t payloadChecksum;  // FNV-1a по массиву Node
+    uint64_t metadataChecksum; // FNV-1a по заголовку (с этим полем = 0), емкостям и индексу объёмов
+};
+
+// parent — индекс родителя + 1 (0 — недостижимо, корень ссылается сам на себя).
+struct Node {
+    uint32_t parent;
+    uint32_t depth;
+};
+
+inline auto fnv1a(const void* data, size_t size, uint64_t hash = 0xcbf29ce484222325ULL) -> uint64_t {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+inline auto align8(size_t bytes) -> size_t { return (bytes + 7) & ~size_t{7}; }
+
+inline auto nodesOffset(size_t jugs, size_t volumes) -> size_t {
+    return align8(sizeof(Header) + jugs * sizeof(int32_t) + volumes * sizeof(uint32_t));
+}
+
+inline auto metadataChecksum(Header header, const std::byte* rest, size_t restBytes) -> uint64_t {
+    header.metadataChecksum = 0;
+    return fnv1a(rest, restBytes, fnv1a(&header, sizeof(header)));
+}
+
+inline auto fileName(const std::vector<int>& capacities) -> std::string {
+    std::string name = "jugs";
+    for (int capacity : capacities) {
+        name += "-" + std::to_string(capacity);
+    }
+    return name + ".bfs";
+}
+
+// Обход в ширину и запись таблицы. Пишется во временный файл, который затем
+// атомарно переименовывается, поэтому читатели не видят недописанных файлов.
+inline void writeTable(const std::string& path, const JugsProblem& problem) {
+    VolumeTable table(problem);
+    const StateStore& store = table.store();
+
+    std::vector<Node> nodes(problem.stateCount());
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        auto index = static_cast<StateStore::Index>(i);
+        if (store.isDiscovered(index)) {
+            nodes[i] = {store.parentOf(index) + 1, static_cast<uint32_t>(store.costOf(index))};
+        }
+    }
+
+    std::vector<uint32_t> firstStates(table.volumeCount());
+    for (size_t v = 0; v < firstStates.size(); ++v) {
+        firstStates[v] = table.firstStateOf(static_cast<int>(v));
+    }
+    std::vector<int32_t> capacities(problem.capacities().begin(), problem.capacities().end());
+
+    Header header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.jugCount = static_cast<uint32_t>(capacities.size());
+    header.stateCount = nodes.size();
+    header.volumeCount = static_cast<uint32_t>(firstStates.size());
+    header.initialIndex = problem.indexOf(problem.initial());
+    header.payloadChecksum = fnv1a(nodes.data(), nodes.size() * sizeof(Node));
+
+    std::vector<std::byte> metadata(nodesOffset(capacities.size(), firstStates.size()) - sizeof(Header));
+    std::memcpy(metadata.data(), capacities.data(), capacities.size() * sizeof(int32_t));
+    std::memcpy(metadata.data() + capacities.size() * sizeof(int32_t), firstStates.data(),
+                firstStates.size() * sizeof(uint32_t));
+    header.metadataChecksum = metadataChecksum(header, metadata.data(), metadata.size());
+
+    std::string temporary = path + ".tmp-" + std::to_string(::getpid());
+    {
+        std::ofstream out(temporary, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(metadata.data()), static_cast<std::streamsize>(metadata.size()));
+        out.write(reinterpret_cast<const char*>(nodes.data()),
+                  static_cast<std::streamsize>(nodes.size() * sizeof(Node)));
+        if (!out) {
+            std::filesystem::remove(temporary);
+            throw std::runtime_error("не удалось записать " + temporary);
+        }
+    }
+    std::filesystem::rename(temporary, path);
+}
+
+// Отображённая таблица одной конфигурации.
+class CachedTable {
+public:
+    CachedTable(const std::string& path, const std::vector<int>& capacities, bool verifyPayload)
+        : file_(path) {
+        if (file_.size() < sizeof(Header)) {
+            throw std::runtime_error(path + ": файл кэша слишком мал");
+        }
+        std::memcpy(&header_, file_.data(), sizeof(header_));
+        if (std::memcmp(header_.magic, kMagic, sizeof(kMagic)) != 0 || header_.version != kVersion) {
+            throw std::runtime_error(path + ": не файл кэша или неподдерживаемая версия");
+        }
+        size_t offset = nodesOffset(header_.jugCount, header_.volumeCount);
+        if (file_.size() != offset + header_.stateCount * sizeof(Node)) {
+            throw std::runtime_error(path + ": размер файла не совпадает с заголовком");
+        }
+        const std::byte* metadata = file_.data() + sizeof(Header);
+        if (metadataChecksum(header_, metadata, offset - sizeof(Header)) != header_.metadataChecksum) {
+            throw std::runtime_error(path + ": неверная контрольная сумма заголовка");
+        }
+        std::vector<int32_t> stored(header_.jugCount);
+        std::memcpy(stored.data(), metadata, stored.size() * sizeof(int32_t));
+        if (!std::equal(stored.begin(), stored.end(), capacities.begin(), capacities.end())) {
+            throw std::runtime_error(path + ": файл кэша для другой конфигурации");
+        }
+        firstStates_ = reinterpret_cast<const uint32_t*>(metadata + stored.size() * sizeof(int32_t));
+        nodes_ = reinterpret_cast<const Node*>(file_.data() + offset);
+        if (verifyPayload && fnv1a(nodes_, header_.stateCount * sizeof(Node)) != header_.payloadChecksum) {
+            throw std::runtime_error(path + ": неверная контрольная сумма таблицы");
+        }
+    }
+
+    auto bytes() const -> size_t { return file_.size(); }
+
+    // Путь до первого состояния с объёмом target; цепочка проверяется.
+    auto query(const JugsProblem& problem) const -> SearchResult<JugsProblem::State> {
+        SearchResult<JugsProblem::State> result;
+        int target = problem.targetVolume();
+        if (target < 0 || static_cast<uint32_t>(target) >= header_.volumeCount || firstStates_[target] == kNone) {
+            return result;
+        }
+
+        std::vector<uint32_t> chain;
+        uint32_t current = firstStates_[target];
+        while (true) {
+            if (current >= header_.stateCount || nodes_[current].parent == 0) {
+                throw std::runtime_error("повреждённая цепочка родителей в кэше");
+            }
+            chain.push_back(current);
+            const Node& node = nodes_[current];
+            if (node.parent == current + 1) {
+                break;
+            }
+            uint32_t parent = node.parent - 1;
+            if (parent >= header_.stateCount || nodes_[parent].depth + 1 != node.depth) {
+                throw std::runtime_error("повреждённая цепочка родителей в кэше");
+            }
+            current = parent;
+        }
+        if (current != header_.initialIndex) {
+            throw std::runtime_error("цепочка в кэше не ведёт к начальному состоянию");
+        }
+
+        result.pathFound = true;
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+            result.path.push_back(problem.stateOf(*it));
+        }
+        return result;
+    }
+
+private:
+    MappedFile file_;
+    Header header_{};
+    const uint32_t* firstStates_ = nullptr;
+    const Node* nodes_ = nullptr;
+};
+
+} // namespace cache_detail
+
+class SolutionCache {
+public:
+    explicit SolutionCache(std::string directory, CacheLimits limits = {})
+        : directory_(std::move(directory)), limits_(limits) {
+        std::filesystem::create_directories(directory_);
+    }
+
+    auto hits() const -> uint64_t { return hits_; }
+    auto misses() const -> uint64_t { return misses_; }
+
+    // Ответ из кэша; при промахе или повреждении — обход и запись таблицы.
+    // Если таблица больше лимита, ответ вычисляется без кэширования.
+    auto solve(const JugsProblem& problem) -> SearchResult<JugsProblem::State> {
+        std::string path = (directory_ / cache_detail::fileName(problem.capacities())).string();
+
+        if (auto table = open(path, problem)) {
+            try {
+                SearchResult<JugsProblem::State> result = table->query(problem);
+                hits_++;
+                touch(path);
+                return result;
+            } catch (const std::runtime_error&) {
+                forget(path);
+            }
+        }
+
+        misses_++;
+        size_t expected = cache_detail::nodesOffset(problem.jugCount(), 0)
+                          + problem.stateCount() * sizeof(cache_detail::Node);
+        if (expected > limits_.maxBytes) {
+            return VolumeTable(problem).query(problem.targetVolume());
+        }
+        cache_detail::writeTable(path, problem);
+        evict(path);
+        return open(path, problem)->query(problem);
+    }
+
+private:
+    using Table = cache_detail::CachedTable;
+
+    // Открытые таблицы процесса, от недавних к давним.
+    struct Open {
+        std::string path;
+        std::shared_ptr<const Table> table;
+    };
+
+    auto open(const std::string& path, const JugsProblem& problem) -> std::shared_ptr<const Table> {
+        for (auto it = open_.begin(); it != open_.end(); ++it) {
+            if (it->path == path) {
+                open_.splice(open_.begin(), open_, it);
+                return it->table;
+            }
+        }
+        if (!std::filesystem::exists(path)) {
+            return nullptr;
+        }
+        std::shared_ptr<const Table> table;
+        try {
+            table = std::make_shared<const Table>(path, problem.capacities(), limits_.verifyPayload);
+        } catch (const std::runtime_error&) {
+            forget(path);
+            return nullptr;
+        }
+        open_.push_front({path, table});
+        if (open_.size() > limits_.maxEntries) {
+            open_.pop_back();
+        }
+        return table;
+    }
+
+    void forget(const std::string& path) {
+        open_.remove_if([&](const Open& entry) { return entry.path == path; });
+        std::error_code ignored;
+        std::filesystem::remove(path, ignored);
+    }
+
+    static void touch(const std::string& path) {
+        std::error_code ignored;
+        std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ignored);
+    }
+
+    // Удаляет самые давние файлы, пока каталог не уложится в лимиты.
+    // Только что записанный файл keep не удаляется.
+    void evict(const std::string& keep) {
+        struct Entry {
+            std::filesystem::file_time_type used;
+            uint64_t bytes;
+            std::string path;
+        };
+        std::vector<Entry> entries;
+        uint64_t total = 0;
+        std::error_code error;
+        for (const auto& file : std::filesystem::directory_iterator(directory_, error)) {
+            if (file.path().extension() != ".bfs") {
+                continue;
+            }
+            Entry entry{file.last_write_time(error), file.file_size(error), file.path().string()};
+            if (!error) {
+                total += entry.bytes;
+                entries.push_back(std::move(entry));
+            }
+        }
+        std::sort(entries.begin(), entries.end(),
+                  [](const Entry& a, const Entry& b) { return a.used < b.used; });
+        size_t count = entries.size();
+        for (const Entry& entry : entries) {
+            if (total <= limits_.maxBytes && count <= limits_.maxEntries) {
+                break;
+            }
+            if (entry.path == keep) {
+                continue;
+            }
+            forget(entry.path);
+            total -= entry.bytes;
+            count--;
+        }
+    }
+
+    std::filesystem::path directory_;
+    CacheLimits limits_;
+    std::list<Open> open_;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+};
+
+// bfs через кэш решений из options.cache; без кэша — обычный bfs.
+inline auto cachedBfs(const JugsProblem& problem,
+                      StateStore& store,
+                      const SearchOptions& options = {}) -> SearchResult<JugsProblem::State> {
+    if (!options.cache) {
+        return bfs(problem, store, options);
+    }
+    SearchResult<JugsProblem::State> result = options.cache->solve(problem);
+    result.visitedNodes = static_cast<uint32_t>(result.path.size());
+    return result;
+}
+
+#endif
@@ -0,0 +1,227 @@
+#ifndef SUCCINCT_BFS_HPP
+#define SUCCINCT_BFS_HPP
+
+#include "engine.hpp"
+#include "../misc/succinct_closed_list.hpp"
+#include <unordered_map>
+
+// Задача с пронумерованными ходами: преемники вместе с номером хода и
+// обратный ход — все состояния, из которых данный ход ведёт в данное.
+template <typename P>
+concept MoveIndexedProblem = SearchProblem<P> && requires(const P& p, const typename P::State& s, int m) {
+    { p.moveCount() } -> std::convertible_to<int>;
+    p.forEachMove(s, [](const typename P::State&, int, int) {});
+    p.forEachInverse(s, m, [](const typename P::State&, int) {});
+};
+
+// Задача, умеющая раскрывать блок индексов разом с отсевом по битовому
+// множеству посещённых (см. JugsProblem::expandBatch).
+template <typename P>
+concept BatchExpandableProblem = MoveIndexedProblem<P>
+    && requires(const P& p, const StateStore::Index* indices, const uint64_t* visited,
+                typename P::BatchSuccessor* out) {
+    { p.canExpandBatch() } -> std::convertible_to<bool>;
+    { p.expandBatch(indices, size_t{1}, visited, out) } -> std::convertible_to<size_t>;
+};
+
+namespace succinct_detail {
+
+inline constexpr size_t kBatchStates = 64; // состояний фронта в одном пакете
+
+// Элемент пакета; у задач без пакетного раскрытия буфер пакета не нужен.
+template <typename P>
+struct BatchBuffer {
+    using Successor = char;
+};
+
+template <BatchExpandableProblem P>
+struct BatchBuffer<P> {
+    using Successor = typename P::BatchSuccessor;
+};
+
+// Путь от корня до цели на глубине depth по одним кодам. Обратный поиск по
+// слоям: в слой k + 1 попадают посещённые состояния с глубиной
+// depth - k - 1 по модулю 3, из которых ход, записанный у состояния слоя k,
+// ведёт в него. Цепочка родителей BFS среди них всегда есть, поэтому корень
+// достигается ровно на слое depth, и найденный путь кратчайший. Ложные
+// кандидаты (той же глубины по модулю, но глубже) отсекаются на следующих
+// слоях: из них корень не достигается за оставшиеся шаги. Восстановление
+// дороже, чем по родителям StateStore: обратный ход наполнения или
+// опустошения перебирает до ёмкости сосуда кандидатов на шаг пути.
+template <MoveIndexedProblem Problem>
+inline auto reconstruct(const Problem& problem,
+                        const SuccinctClosedList& closed,
+                        StateStore::Index goalIndex,
+                        int depth,
+                        std::pmr::memory_resource* resource) -> std::vector<typename Problem::State> {
+    using State = typename Problem::State;
+    using Index = StateStore::Index;
+
+    // Следующее состояние на пути к цели для каждого найденного предшественника
+    std::pmr::unordered_map<Index, Index> towardGoal(resource);
+    std::pmr::vector<Index> layer({goalIndex}, resource);
+    std::pmr::vector<Index> nextLayer(resource);
+    towardGoal.emplace(goalIndex, goalIndex);
+    Index rootIndex = goalIndex;
+
+    for (int k = 0; k < depth && !closed.isRoot(rootIndex); ++k) {
+        int wanted = (depth - k - 1) % 3;
+        nextLayer.clear();
+        for (Index current : layer) {
+            problem.forEachInverse(problem.stateOf(current), closed.moveOf(current), [&](const State& previous, int) {
+                Index previousIndex = problem.indexOf(previous);
+                if (!closed.isVisited(previousIndex) || closed.depthMod3(previousIndex) != wanted
+                    || !towardGoal.emplace(previousIndex, current).second) {
+                    return;
+                }
+                if (closed.isRoot(previousIndex)) {
+                    rootIndex = previousIndex;
+                }
+                nextLayer.push_back(previousIndex);
+            });
+        }
+        layer.swap(nextLayer);
+    }
+
+    std::vector<State> path;
+    path.reserve(static_cast<size_t>(depth) + 1);
+    for (Index current = rootIndex;; current = towardGoal.at(current)) {
+        path.push_back(problem.stateOf(current));
+        if (current == goalIndex) {
+            break;
+        }
+    }
+    return path;
+}
+
+} // namespace succinct_detail
+
+// Поиск в ширину с компактным закрытым списком: вместо узла StateStore на
+// каждое состояние — бит посещения и код хода с глубиной по модулю 3.
+// Раскрывает вершины в том же порядке, что и bfs, и находит путь той же
+// длины. Если задача умеет раскрывать пакетами, фронт раскрывается блоками
+// через её векторное ядро. Переданное хранилище не используется; выделенная под него память
+// calloc остаётся нетронутой и физически не занимается.
+template <MoveIndexedProblem Problem>
+inline auto succinctBfs(const Problem& problem,
+                        StateStore&,
+                        const SearchOptions& options = {}) -> SearchResult<typename Problem::State> {
+    using State = typename Problem::State;
+    using Index = StateStore::Index;
+
+    SuccinctClosedList closed(problem.stateCount(), problem.moveCount());
+    std::pmr::memory_resource* resource = searchResource(options);
+    std::pmr::vector<Index> frontier(resource);
+    std::pmr::vector<Index> nextFrontier(resource);
+    SearchTree* tree = options.tree;
+    SearchProbe probe(options.stats);
+
+    Index startIndex = problem.indexOf(problem.initial());
+    closed.setRoot(startIndex);
+    if (tree) {
+        tree->addRoot(startIndex);
+    }
+    frontier.push_back(startIndex);
+
+    SearchResult<State> result;
+    Index targetIndex = startIndex;
+    int depth = 0;
+
+    // Раскрытие одного состояния: до пакета дело доходит, только если это не цель
+    auto visit = [&](Index currentIndex) -> bool {
+        result.visitedNodes++;
+        probe.count(&SearchStats::expansions);
+        if (problem.isGoal(problem.stateOf(currentIndex))) {
+            result.pathFound = true;
+            targetIndex = currentIndex;
+            return false;
+        }
+        return true;
+    };
+
+    auto discover = [&](Index currentIndex, Index nextIndex, int move) {
+        if (closed.isVisited(nextIndex)) {
+            probe.count(&SearchStats::duplicates);
+            return;
+        }
+        if (tree) {
+            tree->addEdge(currentIndex, nextIndex);
+        }
+        closed.mark(nextIndex, move, depth + 1);
+        nextFrontier.push_back(nextIndex);
+    };
+
+    // Пакетный путь: блок фронта раскрывается ядром задачи, которое сразу
+    // отсеивает посещённые преемники. Порядок обнаружения тот же, что у
+    // поштучного раскрытия.
+    bool batched = false;
+    std::pmr::vector<typename succinct_detail::BatchBuffer<Problem>::Successor> batch(resource);
+    if constexpr (BatchExpandableProblem<Problem>) {
+        batched = problem.canExpandBatch();
+        if (batched) {
+            batch.resize(succinct_detail::kBatchStates * static_cast<size_t>(problem.moveCount()));
+        }
+    }
+
+    for (; !frontier.empty() && !result.pathFound; ++depth) {
+        nextFrontier.clear();
+        if (batched) {
+            if constexpr (BatchExpandableProblem<Problem>) {
+                for (size_t begin = 0; begin < frontier.size() && !result.pathFound;
+                     begin += succinct_detail::kBatchStates) {
+                    size_t end = std::min(begin + succinct_detail::kBatchStates, frontier.size());
+                    size_t count = 0;
+                    for (size_t k = begin; k < end; ++k, ++count) {
+                        if (stopRequested(options, result.visitedNodes)) {
+                            return result;
+                        }
+                        if (!visit(frontier[k])) {
+                            break;
+                        }
+                    }
+                    size_t found = problem.expandBatch(frontier.data() + begin, count, closed.visitedWords(),
+                                                       batch.data());
+                    probe.count(&SearchStats::generated, count * static_cast<size_t>(problem.moveCount()));
+                    probe.count(&SearchStats::duplicates, count * static_cast<size_t>(problem.moveCount()) - found);
+                    for (size_t k = 0; k < found; ++k) {
+                        const auto& successor = batch[k];
+                        discover(frontier[begin + successor.source], successor.index, static_cast<int>(successor.move));
+                    }
+                }
+            }
+        } else {
+            for (Index currentIndex : frontier) {
+                if (stopRequested(options, result.visitedNodes)) {
+                    return result;
+                }
+                if (!visit(currentIndex)) {
+                    break;
+                }
+                problem.forEachMove(problem.stateOf(currentIndex), [&](const State& nextState, int, int move) {
+                    probe.count(&SearchStats::generated);
+                    discover(currentIndex, problem.indexOf(nextState), move);
+                });
+            }
+        }
+        probe.observeMax(&SearchStats::peakOpenSize, nextFrontier.size());
+        if (!result.pathFound) {
+            frontier.swap(nextFrontier);
+        }
+    }
+
+    if (result.pathFound) {
+        result.path = probe.timed(&SearchStats::reconstructionSeconds, [&] {
+            return succinct_detail::reconstruct(problem, closed, targetIndex, depth - 1, resource);
+        });
+    }
+
+    if (probe.enabled()) {
+        probe.count(&SearchStats::bytesAllocated,
+                    closed.memoryBytes() + options.stats->peakOpenSize * sizeof(Index)
+                    + result.path.capacity() * sizeof(State));
+    }
+
+    return result;
+}
+
+#endif
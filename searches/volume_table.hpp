@@ -0,0 +1,89 @@
+#ifndef VOLUME_TABLE_HPP
+#define VOLUME_TABLE_HPP
+
+#include "../problems/jugs.hpp"
+#include "../misc/state_store.hpp"
+#include <algorithm>
+#include <limits>
+
+// Таблица достижимых объёмов для одной конфигурации сосудов. Один полный
+// обход в ширину от начального состояния запоминает для каждого объёма
+// первое снятое с очереди состояние, где он встречается в каком-либо сосуде.
+// Порядок обхода совпадает с bfs, поэтому ответ на запрос — тот же путь,
+// что нашёл бы bfs для этой цели, но без нового поиска.
+class VolumeTable {
+public:
+    using State = JugsProblem::State;
+    using Index = StateStore::Index;
+
+    explicit VolumeTable(const JugsProblem& problem)
+        : problem_(problem),
+          store_(problem.stateCount()),
+          firstState_(static_cast<size_t>(*std::max_element(problem.capacities().begin(),
+                                                            problem.capacities().end())) + 1,
+                      unreached) {
+        Index startIndex = problem_.indexOf(problem_.initial());
+        store_.setRoot(startIndex);
+
+        std::vector<Index> queue;
+        queue.push_back(startIndex);
+
+        for (size_t head = 0; head < queue.size(); ++head) {
+            Index currentIndex = queue[head];
+            State currentState = problem_.stateOf(currentIndex);
+            visitedNodes_++;
+
+            for (size_t jug = 0; jug < problem_.jugCount(); ++jug) {
+                Index& first = firstState_[problem_.volume(currentState, jug)];
+                if (first == unreached) {
+                    first = currentIndex;
+                }
+            }
+
+            int nextCost = store_.costOf(currentIndex) + 1;
+            problem_.forEachSuccessor(currentState, [&](const State& nextState, int) {
+                Index nextIndex = problem_.indexOf(nextState);
+                if (!store_.isDiscovered(nextIndex)) {
+                    store_.setParent(nextIndex, currentIndex, nextCost);
+                    queue.push_back(nextIndex);
+                }
+            });
+        }
+    }
+
+    auto visitedNodes() const -> uint32_t { return visitedNodes_; }
+
+    auto isReachable(int volume) const -> bool {
+        return volume >= 0 && static_cast<size_t>(volume) < firstState_.size()
+               && firstState_[volume] != unreached;
+    }
+
+    // Число ходов до первого состояния с данным объёмом.
+    auto depthOf(int volume) const -> int {
+        return isReachable(volume) ? store_.costOf(firstState_[volume]) : -1;
+    }
+
+    auto query(int volume) const -> SearchResult<State> {
+        SearchResult<State> result;
+        if (isReachable(volume)) {
+            result.pathFound = true;
+            result.path = store_.pathTo(problem_, firstState_[volume]);
+        }
+        return result;
+    }
+
+    // Для выгрузки таблицы целиком (searches/solution_cache.hpp).
+    auto store() const -> const StateStore& { return store_; }
+    auto volumeCount() const -> size_t { return firstState_.size(); }
+    auto firstStateOf(int volume) const -> Index { return firstState_[volume]; }
+
+    static constexpr Index unreached = std::numeric_limits<Index>::max();
+
+private:
+    JugsProblem problem_;
+    StateStore store_;
+    std::vector<Index> firstState_;
+    uint32_t visitedNodes_ = 0;
+};
+
+#endif
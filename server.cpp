@@ -0,0 +1,651 @@
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <stop_token>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "problems/jugs.hpp"
+#include "misc/types.hpp"
+#include "misc/bounded_queue.hpp"
+#include "misc/json.hpp"
+#include "misc/common_functions.hpp"
+#include "searches/algorithms.hpp"
+
+// Долгоживущий решатель: читает запросы в формате JSON по одному на строку
+// (stdin или Unix-сокет), раздаёт их фиксированному пулу рабочих потоков и
+// пишет ответы по мере готовности — порядок ответов не совпадает с порядком
+// запросов, их связывает поле "id". Очередь между чтением и пулом ограничена:
+// когда она полна, чтение приостанавливается.
+//
+// Запрос:
+//   {"id": 1, "capacities": [3, 5], "target": 4, "algorithm": "bfs",
+//    "costs": [1, 1, 1, 0], "path": true, "limits": {"max_states": 1000000}}
+// algorithm "portfolio" запускает все алгоритмы одновременно; "quality":
+// "any" | "optimal" задает требование к ответу, победитель — в поле "winner".
+// Ответ:
+//   {"id": 1, "algorithm": "bfs", "found": true, "path_length": 7, ...}
+// В limits можно ограничить сам поиск: "deadline_ms" — срок от начала поиска,
+// "max_expansions" — число раскрытий (только bfs, ucs, dfs, astar). Не
+// уложившийся поиск отвечает "status": "budget_exhausted" и прогрессом
+// (expanded, open_size) вместо пути. Сеанс поиска на этом заканчивается:
+// продолжения нет, повторный запрос с большим бюджетом начинает заново.
+// Портфелю доступен только deadline_ms: по сроку он останавливается
+// целиком и отвечает "status": "stopped". Каждый член портфеля держит свое
+// хранилище, поэтому max_states ограничивает их сумму: в портфель попадает
+// столько алгоритмов, сколько хранилищ помещается в предел.
+// Метрики очереди: {"op": "metrics"} — отвечает читатель сразу, минуя очередь.
+
+namespace {
+
+struct ServerConfig {
+    std::string socketPath;
+    unsigned workers = std::max(1u, std::thread::hardware_concurrency());
+    size_t queueDepth = 256;
+    size_t maxStates = size_t{1} << 26;
+    unsigned searchThreads = 1; // для pbfs: параллельность уже дает пул
+};
+
+void printUsage() {
+    std::cerr <<
+        "Использование: server [опции]\n"
+        "  --socket PATH       слушать Unix-сокет вместо stdin/stdout\n"
+        "  --workers N         рабочие потоки (по умолчанию все ядра)\n"
+        "  --queue-depth N     длина очереди запросов (256); полная очередь\n"
+        "                      приостанавливает чтение\n"
+        "  --max-states N      предел размера пространства состояний (67108864)\n"
+        "  --threads N         потоки pbfs внутри одного запроса (1)\n";
+}
+
+auto parseArguments(int argc, char** argv) -> ServerConfig {
+    ServerConfig config;
+    auto value = [&](int& i) -> std::string {
+        if (i + 1 >= argc) {
+            throw std::invalid_argument(std::string("нет значения для ") + argv[i]);
+        }
+        return argv[++i];
+    };
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--socket") {
+            config.socketPath = value(i);
+        } else if (arg == "--workers") {
+            config.workers = std::max(1u, static_cast<unsigned>(std::stoul(value(i))));
+        } else if (arg == "--queue-depth") {
+            config.queueDepth = std::stoul(value(i));
+        } else if (arg == "--max-states") {
+            config.maxStates = std::stoul(value(i));
+        } else if (arg == "--threads") {
+            config.searchThreads = static_cast<unsigned>(std::stoul(value(i)));
+        } else if (arg == "--help" || arg == "-h") {
+            printUsage();
+            std::exit(0);
+        } else {
+            throw std::invalid_argument("неизвестный параметр: " + arg);
+        }
+    }
+    return config;
+}
+
+// Клиент: дескриптор для ответов. Ответы пишутся целыми строками под
+// мьютексом, поэтому строки разных рабочих потоков не перемешиваются.
+class Connection {
+public:
+    Connection(int fd, bool owned) : fd_(fd), owned_(owned) {}
+
+    Connection(const Connection&) = delete;
+    auto operator=(const Connection&) -> Connection& = delete;
+
+    ~Connection() {
+        if (owned_) {
+            ::close(fd_);
+        }
+    }
+
+    // Ошибки записи (клиент ушел) не прерывают работу сервера.
+    void send(std::string line) {
+        line += '\n';
+        std::lock_guard lock(mutex_);
+        size_t written = 0;
+        while (written < line.size()) {
+            ssize_t n = ::write(fd_, line.data() + written, line.size() - written);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return;
+            }
+            written += static_cast<size_t>(n);
+        }
+    }
+
+private:
+    int fd_;
+    bool owned_;
+    std::mutex mutex_;
+};
+
+// Построчное чтение из дескриптора.
+class LineReader {
+public:
+    explicit LineReader(int fd) : fd_(fd) {}
+
+    auto next(std::string& line) -> bool {
+        while (true) {
+            size_t newline = buffer_.find('\n', scanned_);
+            if (newline != std::string::npos) {
+                line.assign(buffer_, 0, newline);
+                buffer_.erase(0, newline + 1);
+                scanned_ = 0;
+                return true;
+            }
+            scanned_ = buffer_.size();
+            char chunk[1 << 16];
+            ssize_t n = ::read(fd_, chunk, sizeof(chunk));
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                // Последняя строка без перевода строки тоже запрос
+                line = std::move(buffer_);
+                buffer_.clear();
+                scanned_ = 0;
+                return !line.empty();
+            }
+            buffer_.append(chunk, static_cast<size_t>(n));
+        }
+    }
+
+private:
+    int fd_;
+    std::string buffer_;
+    size_t scanned_ = 0;
+};
+
+struct Job {
+    std::shared_ptr<Connection> connection;
+    JsonValue request;
+    std::chrono::steady_clock::time_point received;
+};
+
+struct Metrics {
+    std::atomic<uint64_t> received{0};
+    std::atomic<uint64_t> completed{0};
+    std::atomic<uint64_t> failed{0};
+    std::atomic<uint32_t> inFlight{0};
+};
+
+// Рабочее пространство потока: память поиска, которая между запросами
+// сбрасывается, а не освобождается, и последняя конфигурация с набором
+// алгоритмов для нее — серии запросов к одной конфигурации не пересобирают
+// задачу.
+struct Workspace {
+    SearchWorkspace search;
+    std::optional<JugsProblem> problem;
+    std::vector<JugsAlgorithm> algorithms;
+};
+
+// id запроса возвращается как есть: строка или число.
+auto idField(const JsonValue& request) -> std::string {
+    const JsonValue* id = request.find("id");
+    if (!id) {
+        return "null";
+    }
+    if (id->isString()) {
+        return jsonQuote(id->asString());
+    }
+    if (id->isNumber()) {
+        std::ostringstream out;
+        out << std::setprecision(17) << id->asNumber();
+        return out.str();
+    }
+    return "null";
+}
+
+auto errorResponse(const JsonValue& request, const std::string& message) -> std::string {
+    return "{\"id\": " + idField(request) + ", \"error\": " + jsonQuote(message) + "}";
+}
+
+// Число поля, которое должно поместиться в int: значения вне диапазона
+// отвергаются, а не заворачиваются приведением.
+auto intValue(const JsonValue& item, const char* name) -> int {
+    int64_t value = item.asInt();
+    if (value < std::numeric_limits<int>::min() || value > std::numeric_limits<int>::max()) {
+        throw std::invalid_argument(std::string("поле ") + name + " вне диапазона int");
+    }
+    return static_cast<int>(value);
+}
+
+auto intArray(const JsonValue* field, const char* name) -> std::vector<int> {
+    if (!field || !field->isArray()) {
+        throw std::invalid_argument(std::string("поле ") + name + " должно быть массивом чисел");
+    }
+    std::vector<int> values;
+    for (const JsonValue& item : field->asArray()) {
+        if (!item.isNumber()) {
+            throw std::invalid_argument(std::string("поле ") + name + " должно быть массивом чисел");
+        }
+        values.push_back(intValue(item, name));
+    }
+    return values;
+}
+
+auto sameConfiguration(const JugsProblem& problem, const std::vector<int>& capacities, int target,
+                       const MoveCosts& costs) -> bool {
+    const MoveCosts& current = problem.costs();
+    return problem.capacities() == capacities && problem.targetVolume() == target
+           && current.fill == costs.fill && current.empty == costs.empty
+           && current.pour == costs.pour && current.perLiter == costs.perLiter;
+}
+
+// Отмена запроса по сроку: сторожевой поток запрашивает остановку token(),
+// если поиск не закончился к сроку. Деструктор будит и дожидается сторожа.
+class DeadlineStop {
+public:
+    explicit DeadlineStop(std::chrono::steady_clock::time_point deadline)
+        : watchdog_([this, deadline](std::stop_token done) {
+              std::mutex mutex;
+              std::condition_variable_any wake;
+              std::unique_lock lock(mutex);
+              if (!wake.wait_until(lock, done, deadline, [] { return false; }) && !done.stop_requested()) {
+                  cancel_.request_stop();
+              }
+          }) {}
+
+    auto token() const -> std::stop_token { return cancel_.get_token(); }
+
+private:
+    std::stop_source cancel_;
+    std::jthread watchdog_;
+};
+
+// Поиск в пределах бюджета: возобновляемый сеанс, один шаг.
+struct BoundedAnswer {
+    SearchResult<JugsProblem::State> result;
+    SearchStatus status = SearchStatus::Running;
+    SearchProgress progress;
+};
+
+// Статус ограниченного поиска в ответе. Сеанс сервера не переживает
+// запрос, поэтому «бюджет исчерпан» — окончательный ответ, а не running.
+auto boundedStatusName(SearchStatus status) -> const char* {
+    return status == SearchStatus::Running ? "budget_exhausted" : statusName(status);
+}
+
+using BoundedFunction = BoundedAnswer (*)(const JugsProblem&, StateStore&, const SearchOptions&,
+                                          const SearchBudget&);
+
+template <typename Session>
+auto boundedSearch(const JugsProblem& problem, StateStore& store, const SearchOptions& options,
+                   const SearchBudget& budget) -> BoundedAnswer {
+    Session session(problem, store, options);
+    SearchStatus status = session.step(budget);
+    return {session.takeResult(), status, session.progress()};
+}
+
+auto boundedSearchFor(const std::string& algorithm) -> BoundedFunction {
+    if (algorithm == "bfs") {
+        return boundedSearch<BfsSession<JugsProblem>>;
+    }
+    if (algorithm == "ucs") {
+        return boundedSearch<UcsSession<JugsProblem>>;
+    }
+    if (algorithm == "dfs") {
+        return boundedSearch<DfsSession<JugsProblem>>;
+    }
+    if (algorithm == "astar") {
+        return boundedSearch<AstarSession<JugsProblem>>;
+    }
+    return nullptr;
+}
+
+auto solve(const Job& job, Workspace& workspace, const ServerConfig& config) -> std::string {
+    const JsonValue& request = job.request;
+    if (!request.isObject()) {
+        throw std::invalid_argument("запрос должен быть объектом");
+    }
+
+    std::vector<int> capacities = intArray(request.find("capacities"), "capacities");
+    const JsonValue* targetField = request.find("target");
+    if (!targetField || !targetField->isNumber()) {
+        throw std::invalid_argument("нет числового поля target");
+    }
+    int target = intValue(*targetField, "target");
+
+    MoveCosts costs;
+    if (const JsonValue* field = request.find("costs")) {
+        std::vector<int> parts = intArray(field, "costs");
+        if (parts.size() != 4) {
+            throw std::invalid_argument("costs — четыре числа: наполнение, опустошение, переливание, литр");
+        }
+        costs = {parts[0], parts[1], parts[2], parts[3]};
+    }
+
+    std::string algorithmName = "bfs";
+    if (const JsonValue* field = request.find("algorithm")) {
+        if (!field->isString()) {
+            throw std::invalid_argument("поле algorithm должно быть строкой");
+        }
+        algorithmName = field->asString();
+    }
+
+    bool withPath = true;
+    if (const JsonValue* field = request.find("path")) {
+        withPath = field->isBool() && field->asBool();
+    }
+
+    size_t maxStates = config.maxStates;
+    std::optional<int64_t> deadlineMs;
+    std::optional<int64_t> maxExpansions;
+    if (const JsonValue* limits = request.find("limits")) {
+        if (const JsonValue* field = limits->find("max_states")) {
+            maxStates = std::min(maxStates, static_cast<size_t>(std::max<int64_t>(field->asInt(), 0)));
+        }
+        if (const JsonValue* field = limits->find("deadline_ms")) {
+            deadlineMs = std::max<int64_t>(field->asInt(), 0);
+        }
+        if (const JsonValue* field = limits->find("max_expansions")) {
+            maxExpansions = std::max<int64_t>(field->asInt(), 0);
+        }
+    }
+
+    if (!workspace.problem || !sameConfiguration(*workspace.problem, capacities, target, costs)) {
+        workspace.problem.reset();
+        workspace.algorithms.clear();
+        workspace.problem.emplace(capacities, target, costs);
+        workspace.algorithms = jugsAlgorithms(*workspace.problem);
+    }
+    const JugsProblem& problem = *workspace.problem;
+
+    if (problem.stateCount() > maxStates) {
+        throw std::invalid_argument("пространство состояний (" + std::to_string(problem.stateCount())
+                                    + ") больше предела " + std::to_string(maxStates));
+    }
+
+    // "portfolio" — все алгоритмы одновременно, ответ первого подходящего
+    bool portfolio = algorithmName == "portfolio";
+    PortfolioQuality quality = PortfolioQuality::Any;
+    if (const JsonValue* field = request.find("quality")) {
+        if (!field->isString() || (field->asString() != "any" && field->asString() != "optimal")) {
+            throw std::invalid_argument("поле quality — \"any\" или \"optimal\"");
+        }
+        quality = field->asString() == "any" ? PortfolioQuality::Any : PortfolioQuality::Optimal;
+    }
+
+    const JugsAlgorithm* algorithm = nullptr;
+    for (const JugsAlgorithm& candidate : workspace.algorithms) {
+        if (candidate.name == algorithmName) {
+            algorithm = &candidate;
+        }
+    }
+    if (!algorithm && !portfolio) {
+        throw std::invalid_argument("неизвестный или неприменимый алгоритм: " + algorithmName);
+    }
+
+    bool bounded = !portfolio && (deadlineMs || maxExpansions);
+    BoundedFunction boundedFunction = boundedSearchFor(algorithmName);
+    if (bounded && !boundedFunction) {
+        throw std::invalid_argument("deadline_ms и max_expansions поддерживают только bfs, ucs, dfs, astar"
+                                    " и портфель (только deadline_ms)");
+    }
+    if (portfolio && maxExpansions) {
+        throw std::invalid_argument("портфель не поддерживает max_expansions");
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    SearchResult<JugsProblem::State> result;
+    std::string winner = algorithmName;
+    bool solvable = problem.isSolvable();
+    std::optional<BoundedAnswer> partial;
+    bool portfolioStopped = false;
+    if (solvable && bounded) {
+        SearchOptions options;
+        options.workspace = &workspace.search;
+        workspace.search.reset();
+        SearchBudget budget;
+        if (deadlineMs) {
+            budget.deadline = startTime + std::chrono::milliseconds(*deadlineMs);
+        }
+        if (maxExpansions) {
+            budget.expansions = static_cast<uint64_t>(*maxExpansions);
+        }
+        partial = boundedFunction(problem, workspace.search.store(problem.stateCount()), options, budget);
+        result = std::move(partial->result);
+    } else if (solvable) {
+        SearchOptions options;
+        options.threads = config.searchThreads;
+        if (portfolio) {
+            auto entries = jugsPortfolio(problem, workspace.algorithms, quality);
+            // Хранилище на каждого члена: в предел помещается не больше
+            // maxStates / stateCount хранилищ, хотя бы одно есть по проверке выше
+            size_t fitting = maxStates / std::max<size_t>(problem.stateCount(), 1);
+            if (entries.size() > fitting) {
+                entries.erase(entries.begin() + static_cast<std::ptrdiff_t>(fitting), entries.end());
+            }
+            std::optional<DeadlineStop> deadline;
+            if (deadlineMs) {
+                deadline.emplace(startTime + std::chrono::milliseconds(*deadlineMs));
+                options.stop = deadline->token();
+            }
+            auto answer = runPortfolio(problem, entries, options);
+            result = std::move(answer.result);
+            winner = answer.algorithm;
+            portfolioStopped = winner.empty();
+        } else {
+            options.workspace = &workspace.search;
+            workspace.search.reset();
+            result = algorithm->function(problem, workspace.search.store(problem.stateCount()), options);
+        }
+    }
+    auto endTime = std::chrono::steady_clock::now();
+
+    std::ostringstream out;
+    out << std::setprecision(9);
+    out << "{\"id\": " << idField(request)
+        << ", \"algorithm\": " << jsonQuote(algorithmName);
+    if (portfolio) {
+        out << ", \"winner\": " << jsonQuote(winner);
+        if (portfolioStopped) {
+            out << ", \"status\": " << jsonQuote(statusName(SearchStatus::Stopped));
+        }
+    }
+    if (partial) {
+        out << ", \"status\": " << jsonQuote(boundedStatusName(partial->status))
+            << ", \"expanded\": " << partial->progress.expanded
+            << ", \"open_size\": " << partial->progress.openSize;
+    }
+    out        << ", \"solvable\": " << (solvable ? "true" : "false")
+        << ", \"found\": " << (result.pathFound ? "true" : "false")
+        << ", \"path_length\": " << result.path.size()
+        << ", \"path_cost\": " << pathCost(problem, result.path)
+        << ", \"visited\": " << result.visitedNodes
+        << ", \"queue_s\": " << std::chrono::duration<double>(startTime - job.received).count()
+        << ", \"search_s\": " << std::chrono::duration<double>(endTime - startTime).count();
+    if (withPath) {
+        out << ", \"path\": [";
+        for (size_t k = 0; k < result.path.size(); ++k) {
+            out << (k ? ", [" : "[");
+            for (size_t i = 0; i < problem.jugCount(); ++i) {
+                out << (i ? ", " : "") << problem.volume(result.path[k], i);
+            }
+            out << "]";
+        }
+        out << "]";
+    }
+    out << "}";
+    return out.str();
+}
+
+class Server {
+public:
+    explicit Server(const ServerConfig& config) : config_(config), queue_(config.queueDepth) {
+        for (unsigned i = 0; i < config_.workers; ++i) {
+            workers_.emplace_back([this] { work(); });
+        }
+    }
+
+    // Читает запросы клиента до конца потока. Запрос ставится в очередь
+    // и ждет в ней места — так переполнение доходит до клиента.
+    void serve(int inputFd, const std::shared_ptr<Connection>& connection) {
+        LineReader reader(inputFd);
+        for (std::string line; reader.next(line);) {
+            if (line.find_first_not_of(" \t\r") == std::string::npos) {
+                continue;
+            }
+            JsonValue request;
+            try {
+                request = parseJson(line);
+            } catch (const std::exception& e) {
+                metrics_.failed++;
+                connection->send(errorResponse(request, e.what()));
+                continue;
+            }
+            const JsonValue* op = request.find("op");
+            if (op && op->isString() && op->asString() == "metrics") {
+                connection->send(metricsResponse(request));
+                continue;
+            }
+            metrics_.received++;
+            if (!queue_.push({connection, std::move(request), std::chrono::steady_clock::now()})) {
+                return;
+            }
+        }
+    }
+
+    // Оставшиеся запросы дорабатываются, затем потоки пула завершаются.
+    void shutdown() {
+        queue_.close();
+        workers_.clear();
+    }
+
+    auto metricsResponse(const JsonValue& request) const -> std::string {
+        std::ostringstream out;
+        out << "{\"id\": " << idField(request)
+            << ", \"workers\": " << config_.workers
+            << ", \"queue_capacity\": " << queue_.capacity()
+            << ", \"queue_depth\": " << queue_.size()
+            << ", \"peak_queue_depth\": " << queue_.peakSize()
+            << ", \"blocked_pushes\": " << queue_.blockedPushes()
+            << ", \"in_flight\": " << metrics_.inFlight.load()
+            << ", \"received\": " << metrics_.received.load()
+            << ", \"completed\": " << metrics_.completed.load()
+            << ", \"failed\": " << metrics_.failed.load() << "}";
+        return out.str();
+    }
+
+private:
+    void work() {
+        Workspace workspace;
+        while (std::optional<Job> job = queue_.pop()) {
+            metrics_.inFlight++;
+            std::string response;
+            try {
+                response = solve(*job, workspace, config_);
+                metrics_.completed++;
+            } catch (const std::exception& e) {
+                response = errorResponse(job->request, e.what());
+                metrics_.failed++;
+            }
+            metrics_.inFlight--;
+            job->connection->send(std::move(response));
+        }
+    }
+
+    ServerConfig config_;
+    BoundedQueue<Job> queue_;
+    Metrics metrics_;
+    std::vector<std::jthread> workers_;
+};
+
+auto listenUnix(const std::string& path) -> int {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument("слишком длинный путь сокета: " + path);
+    }
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        throw std::runtime_error(std::string("socket: ") + std::strerror(errno));
+    }
+    ::unlink(path.c_str());
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0
+        || ::listen(fd, SOMAXCONN) < 0) {
+        std::string error = std::strerror(errno);
+        ::close(fd);
+        throw std::runtime_error("не удалось слушать " + path + ": " + error);
+    }
+    return fd;
+}
+
+} // namespace
+
+auto main(int argc, char** argv) -> int {
+    ServerConfig config;
+    try {
+        config = parseArguments(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка: " << e.what() << "\n";
+        printUsage();
+        return 1;
+    }
+
+    // Ушедший клиент не должен завершать сервер сигналом при записи
+    std::signal(SIGPIPE, SIG_IGN);
+
+    Server server(config);
+
+    if (config.socketPath.empty()) {
+        server.serve(STDIN_FILENO, std::make_shared<Connection>(STDOUT_FILENO, false));
+        server.shutdown();
+        std::cerr << "Метрики: " << server.metricsResponse({}) << "\n";
+        return 0;
+    }
+
+    int listener = -1;
+    try {
+        listener = listenUnix(config.socketPath);
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка: " << e.what() << "\n";
+        return 1;
+    }
+    std::cerr << "Сервер слушает " << config.socketPath << "\n";
+
+    // Каждый клиент читается своим потоком; очередь и пул общие
+    while (true) {
+        int client = ::accept(listener, nullptr, nullptr);
+        if (client < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "accept: " << std::strerror(errno) << "\n";
+            break;
+        }
+        std::thread([&server, client] {
+            auto connection = std::make_shared<Connection>(client, true);
+            server.serve(client, connection);
+        }).detach();
+    }
+
+    ::close(listener);
+    server.shutdown();
+    return 0;
+}
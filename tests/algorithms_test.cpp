@@ -0,0 +1,117 @@
+#include "test_common.hpp"
+#include "../misc/common_functions.hpp"
+#include "../searches/algorithms.hpp"
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+// Каждый зарегистрированный алгоритм (jugsAlgorithms, включая кэш, базу
+// шаблонов и сокращение по симметрии) против эталонов bfs и ucs на
+// случайных задачах из двух и трёх сосудов во всех моделях стоимости:
+// тот же ответ о достижимости, допустимый путь, а длина и стоимость
+// соответствуют заявленной Optimality. Портфель с требованием Optimal
+// тоже должен вернуть путь минимальной стоимости.
+
+namespace {
+
+// Путь начинается в начальном состоянии, кончается в цели, и каждый шаг — ход задачи.
+auto isValidPath(const JugsProblem& problem, const std::vector<JugsProblem::State>& path) -> bool {
+    if (path.empty() || !(path.front() == problem.initial()) || !problem.isGoal(path.back())) {
+        return false;
+    }
+    for (size_t k = 1; k < path.size(); ++k) {
+        bool step = false;
+        problem.forEachSuccessor(path[k - 1], [&](JugsProblem::State next, int) {
+            step = step || next == path[k];
+        });
+        if (!step) {
+            return false;
+        }
+    }
+    return true;
+}
+
+auto run(AlgorithmFunction<JugsProblem> function, const JugsProblem& problem, const SearchOptions& options)
+    -> SearchResult<JugsProblem::State> {
+    StateStore store(problem.stateCount());
+    return function(problem, store, options);
+}
+
+// База шаблонов по одиночным сосудам для цели задачи.
+void writePatterns(const std::filesystem::path& path, const JugsProblem& problem) {
+    std::vector<uint64_t> patterns;
+    for (size_t i = 0; i < problem.jugCount(); ++i) {
+        patterns.push_back(uint64_t{1} << i);
+    }
+    std::ofstream out(path, std::ios::binary);
+    buildPatternDatabase(out, problem.capacities(), problem.costs(), patterns, {problem.targetVolume()});
+}
+
+void checkAlgorithms(const JugsProblem& problem, const std::filesystem::path& directory, int round) {
+    // Своя база на каждую задачу: файл не перезаписывается, пока отображён
+    std::filesystem::path patternsPath = directory / ("patterns." + std::to_string(round) + ".pdb");
+    writePatterns(patternsPath, problem);
+    PatternDatabase patterns(patternsPath.string());
+    SolutionCache cache((directory / "cache").string());
+
+    SearchOptions options;
+    options.threads = 2;
+    options.externalDirectory = directory.string();
+    options.cache = &cache;
+    options.patterns = &patterns;
+
+    SearchResult<JugsProblem::State> byBfs = run(bfs<JugsProblem>, problem, options);
+    SearchResult<JugsProblem::State> byUcs = run(ucs<JugsProblem>, problem, options);
+    check(byBfs.pathFound == problem.isSolvable(), "bfs расходится с isSolvable: " + describe(problem));
+    long long bestCost = byUcs.pathFound ? pathCost(problem, byUcs.path) : 0;
+
+    std::vector<JugsAlgorithm> algorithms = jugsAlgorithms(problem, options);
+    std::vector<std::string> names = jugsAlgorithmNames();
+    for (const JugsAlgorithm& algorithm : algorithms) {
+        std::string where = algorithm.name + " на " + describe(problem);
+        check(std::find(names.begin(), names.end(), algorithm.name) != names.end(),
+              "алгоритма нет в jugsAlgorithmNames: " + where);
+        SearchResult<JugsProblem::State> result = run(algorithm.function, problem, options);
+        check(result.pathFound == byBfs.pathFound, "достижимость не совпала с bfs: " + where);
+        if (!result.pathFound || !byBfs.pathFound) {
+            continue;
+        }
+        check(isValidPath(problem, result.path), "недопустимый путь: " + where);
+        if (algorithm.optimality == Optimality::Moves) {
+            check(result.path.size() == byBfs.path.size(), "путь длиннее кратчайшего по ходам: " + where);
+        }
+        if (isCostOptimal(algorithm, problem)) {
+            check(pathCost(problem, result.path) == bestCost, "путь дороже минимального: " + where);
+        }
+    }
+
+    PortfolioResult<JugsProblem::State> answer =
+        runPortfolio(problem, jugsPortfolio(problem, algorithms, PortfolioQuality::Optimal), options);
+    check(answer.result.pathFound == byBfs.pathFound, "портфель: достижимость не совпала с bfs: " + describe(problem));
+    if (answer.result.pathFound && byBfs.pathFound) {
+        check(isValidPath(problem, answer.result.path), "портфель: недопустимый путь: " + describe(problem));
+        check(pathCost(problem, answer.result.path) == bestCost,
+              "портфель (" + answer.algorithm + "): путь дороже минимального: " + describe(problem));
+    }
+}
+
+} // namespace
+
+int main() {
+    std::filesystem::path directory =
+        std::filesystem::temp_directory_path() / ("algorithms_test." + std::to_string(getpid()));
+    std::filesystem::create_directories(directory);
+
+    std::mt19937 rng(7);
+    int round = 0;
+    for (const MoveCosts& costs : testCostModels()) {
+        for (int k = 0; k < 15; ++k) {
+            // Малые ёмкости дают и сосуды равной ёмкости, и недостижимые цели
+            checkAlgorithms(randomProblem(rng, 2, 12, costs), directory, round++);
+            checkAlgorithms(randomProblem(rng, 3, 7, costs), directory, round++);
+        }
+    }
+
+    std::filesystem::remove_all(directory);
+    return testExitCode("algorithms_test");
+}
@@ -0,0 +1,148 @@
+#include "test_common.hpp"
+#include <new>
+#include <tuple>
+#include <sys/mman.h>
+
+// Пакетные ядра (problems/jugs_batch.hpp) против последовательного
+// forEachMove: для каждого набора инструкций, который поддерживает
+// процессор, на случайных блоках индексов со случайным битовым множеством
+// посещённых ядро должно выдать тех же непосещённых преемников в том же
+// порядке. Конструктор задачи выбирает лучший набор, поэтому остальные
+// ядра включаются здесь явно через setBatchIsa. Среди задач есть
+// пространства почти в 2^32 состояний: индексы там близки к пределу uint32.
+
+namespace {
+
+using Successor = std::tuple<uint32_t, uint32_t, uint32_t>; // индекс, родитель, ход
+
+auto supported(BatchIsa isa) -> bool {
+#if JUGS_BATCH_X86
+    __builtin_cpu_init();
+    switch (isa) {
+    case BatchIsa::Scalar:
+        return true;
+    case BatchIsa::Sse42:
+        return __builtin_cpu_supports("sse4.2");
+    case BatchIsa::Avx2:
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    case BatchIsa::Avx512:
+        return __builtin_cpu_supports("avx512f");
+    }
+    return false;
+#else
+    return isa == BatchIsa::Scalar;
+#endif
+}
+
+// Битовое множество на всё пространство состояний. Для пространств в 2^32
+// это полгигабайта, поэтому память берётся отображением без резерва:
+// нетронутые страницы читаются нулями и не занимают памяти.
+class VisitedBits {
+public:
+    explicit VisitedBits(size_t stateCount) : bytes_((stateCount + 63) / 64 * sizeof(uint64_t)) {
+        void* memory = ::mmap(nullptr, bytes_, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (memory == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        words_ = static_cast<uint64_t*>(memory);
+    }
+
+    VisitedBits(const VisitedBits&) = delete;
+    auto operator=(const VisitedBits&) -> VisitedBits& = delete;
+
+    ~VisitedBits() { ::munmap(words_, bytes_); }
+
+    auto words() -> uint64_t* { return words_; }
+
+private:
+    size_t bytes_;
+    uint64_t* words_;
+};
+
+// Случайное заполнение только тех слов, которые прочтёт ядро: слов
+// родителей блока и их преемников. density — доля установленных бит из 8.
+void randomizeVisited(const JugsProblem& problem, const std::vector<uint32_t>& block, uint64_t* words,
+                      std::mt19937_64& rng, unsigned density) {
+    auto randomWord = [&] {
+        uint64_t word = 0;
+        for (unsigned bit = 0; bit < 64; ++bit) {
+            word |= uint64_t{rng() % 8 < density} << bit;
+        }
+        return word;
+    };
+    for (uint32_t index : block) {
+        words[index >> 6] = randomWord();
+        problem.forEachSuccessor(problem.stateOf(index), [&](JugsProblem::State next, int) {
+            words[problem.indexOf(next) >> 6] = randomWord();
+        });
+    }
+}
+
+auto expected(const JugsProblem& problem, const std::vector<uint32_t>& block, const uint64_t* words)
+    -> std::vector<Successor> {
+    std::vector<Successor> successors;
+    for (size_t k = 0; k < block.size(); ++k) {
+        problem.forEachMove(problem.stateOf(block[k]), [&](JugsProblem::State next, int, int move) {
+            uint32_t index = problem.indexOf(next);
+            if (!(words[index >> 6] >> (index & 63) & 1)) {
+                successors.emplace_back(index, static_cast<uint32_t>(k), static_cast<uint32_t>(move));
+            }
+        });
+    }
+    return successors;
+}
+
+void checkKernels(JugsProblem& problem, std::mt19937_64& rng, int blocks, uint32_t lowest) {
+    VisitedBits visited(problem.stateCount());
+    size_t jugs = problem.jugCount();
+    std::vector<BatchSuccessor> out;
+    for (int round = 0; round < blocks; ++round) {
+        // Длины до 19 задевают неполные хвосты блоков всех ширин
+        std::vector<uint32_t> block(1 + rng() % 19);
+        uint64_t span = problem.stateCount() - lowest;
+        for (uint32_t& index : block) {
+            index = static_cast<uint32_t>(lowest + rng() % span);
+        }
+        randomizeVisited(problem, block, visited.words(), rng, static_cast<unsigned>(rng() % 9));
+        std::vector<Successor> reference = expected(problem, block, visited.words());
+
+        for (BatchIsa isa : {BatchIsa::Scalar, BatchIsa::Sse42, BatchIsa::Avx2, BatchIsa::Avx512}) {
+            if (!supported(isa)) {
+                continue;
+            }
+            problem.setBatchIsa(isa);
+            out.assign(block.size() * jugs * (jugs + 1), {});
+            size_t written = problem.expandBatch(block.data(), block.size(), visited.words(), out.data());
+            std::vector<Successor> actual;
+            for (size_t k = 0; k < written; ++k) {
+                actual.emplace_back(out[k].index, out[k].source, out[k].move);
+            }
+            check(actual == reference, describe(problem) + ": ядро " + batchIsaName(isa)
+                                           + " расходится с forEachMove на блоке из "
+                                           + std::to_string(block.size()) + " состояний");
+        }
+    }
+}
+
+} // namespace
+
+auto main() -> int {
+    std::mt19937 problemRng(23);
+    std::mt19937_64 rng(2023);
+
+    for (int round = 0; round < 60; ++round) {
+        size_t jugs = 1 + round % 5;
+        JugsProblem problem = randomProblem(problemRng, jugs, jugs <= 3 ? 40 : 9, {1, 1, 1, 0});
+        checkKernels(problem, rng, 20, 0);
+    }
+
+    // Индексы у верхней границы 32-битного пространства
+    for (const std::vector<int>& capacities : {std::vector<int>{65535, 65534}, std::vector<int>{1624, 1624, 1624}}) {
+        JugsProblem problem(capacities, 1);
+        checkKernels(problem, rng, 300, static_cast<uint32_t>(problem.stateCount() - (uint64_t{1} << 24)));
+        checkKernels(problem, rng, 100, 0);
+    }
+
+    return testExitCode("batch_kernel_test");
+}
@@ -0,0 +1,119 @@
+#include "test_common.hpp"
+#include "../searches/ucs.hpp"
+#include "../searches/astar.hpp"
+#include "../misc/common_functions.hpp"
+#include <deque>
+#include <limits>
+#include <stdexcept>
+
+// Семейство эвристик JugsProblem::heuristic: монотонность на каждом ребре
+// случайных задач из двух и трёх сосудов для всех глубин просмотра и
+// моделей стоимости, нулевая оценка в целях, рост с глубиной и при
+// единичных стоимостях — точное значение min(k + 1, число ходов до цели).
+
+namespace {
+
+// Число ходов до ближайшей цели из каждого состояния: обратный BFS от всех целей.
+auto movesToGoal(const JugsProblem& problem) -> std::vector<int> {
+    std::vector<int> distance(problem.stateCount(), std::numeric_limits<int>::max());
+    std::deque<JugsProblem::Index> queue;
+    problem.forEachGoal([&](JugsProblem::State goal) {
+        distance[problem.indexOf(goal)] = 0;
+        queue.push_back(problem.indexOf(goal));
+    });
+    while (!queue.empty()) {
+        JugsProblem::Index current = queue.front();
+        queue.pop_front();
+        problem.forEachPredecessor(problem.stateOf(current), [&](JugsProblem::State previous, int) {
+            JugsProblem::Index index = problem.indexOf(previous);
+            if (distance[index] == std::numeric_limits<int>::max()) {
+                distance[index] = distance[current] + 1;
+                queue.push_back(index);
+            }
+        });
+    }
+    return distance;
+}
+
+void checkFamily(JugsProblem& problem) {
+    std::vector<int> distance = problem.costs().isUnit() ? movesToGoal(problem) : std::vector<int>{};
+    std::vector<int> previous(problem.stateCount(), 0);
+
+    for (int depth = 0; depth <= 2; ++depth) {
+        problem.setHeuristicLookahead(depth);
+        std::vector<int> values(problem.stateCount());
+        for (JugsProblem::Index i = 0; i < problem.stateCount(); ++i) {
+            values[i] = problem.heuristic(problem.stateOf(i));
+        }
+
+        bool consistent = true;
+        bool zeroAtGoals = true;
+        bool growing = true;
+        bool exact = true;
+        for (JugsProblem::Index i = 0; i < problem.stateCount(); ++i) {
+            JugsProblem::State s = problem.stateOf(i);
+            problem.forEachSuccessor(s, [&](JugsProblem::State next, int cost) {
+                consistent = consistent && values[i] <= cost + values[problem.indexOf(next)];
+            });
+            zeroAtGoals = zeroAtGoals && (!problem.isGoal(s) || values[i] == 0);
+            growing = growing && values[i] >= previous[i];
+            if (!distance.empty() && distance[i] != std::numeric_limits<int>::max()) {
+                exact = exact && values[i] == std::min(depth + 1, distance[i]);
+            }
+        }
+
+        std::string where = describe(problem) + ", глубина " + std::to_string(depth);
+        check(consistent, "оценка не монотонна: " + where);
+        check(zeroAtGoals, "ненулевая оценка в цели: " + where);
+        check(growing, "оценка убывает с глубиной: " + where);
+        check(exact, "оценка при единичных стоимостях не равна min(k + 1, ходов до цели): " + where);
+        previous = std::move(values);
+    }
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(12);
+    for (const MoveCosts& costs : testCostModels()) {
+        for (int round = 0; round < 40; ++round) {
+            JugsProblem two = randomProblem(rng, 2, 25, costs);
+            checkFamily(two);
+            JugsProblem three = randomProblem(rng, 3, 9, costs);
+            checkFamily(three);
+        }
+    }
+
+    // A* с оценкой по умолчанию находит путь той же стоимости, что UCS, и
+    // на задачах из трёх сосудов раскрывает в сумме меньше вершин.
+    for (const MoveCosts& costs : testCostModels()) {
+        uint64_t ucsVisited = 0;
+        uint64_t astarVisited = 0;
+        for (int round = 0; round < 40; ++round) {
+            JugsProblem problem = randomProblem(rng, 3, 40, costs);
+            StateStore ucsStore(problem.stateCount());
+            StateStore astarStore(problem.stateCount());
+            SearchResult<JugsProblem::State> byUcs = ucs(problem, ucsStore);
+            SearchResult<JugsProblem::State> byAstar = astar(problem, astarStore);
+            check(byUcs.pathFound == byAstar.pathFound, "A* и UCS расходятся в достижимости: " + describe(problem));
+            if (byUcs.pathFound && byAstar.pathFound) {
+                check(pathCost(problem, byUcs.path) == pathCost(problem, byAstar.path),
+                      "A* нашёл путь дороже UCS: " + describe(problem));
+            }
+            ucsVisited += byUcs.visitedNodes;
+            astarVisited += byAstar.visitedNodes;
+        }
+        check(astarVisited < ucsVisited, "A* раскрыл не меньше вершин, чем UCS: " + std::to_string(astarVisited)
+                                             + " против " + std::to_string(ucsVisited));
+    }
+
+    bool rejected = false;
+    try {
+        JugsProblem({3, 5}, 4).setHeuristicLookahead(JugsProblem::kMaxHeuristicLookahead + 1);
+    } catch (const std::invalid_argument&) {
+        rejected = true;
+    }
+    check(rejected, "недопустимая глубина просмотра принята");
+
+    return testExitCode("heuristic_test");
+}
@@ -0,0 +1,68 @@
+#ifndef TEST_COMMON_HPP
+#define TEST_COMMON_HPP
+
+#include "../problems/jugs.hpp"
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Общее для тестов: счётчик проверок и случайные конфигурации сосудов.
+// Тесты — обычные программы без каркаса; ненулевой код выхода — провал.
+
+namespace test_detail {
+
+inline int failures = 0;
+
+} // namespace test_detail
+
+inline void check(bool condition, const std::string& message) {
+    if (!condition) {
+        test_detail::failures++;
+        std::cerr << "ПРОВАЛ: " << message << std::endl;
+    }
+}
+
+inline auto testExitCode(const std::string& name) -> int {
+    if (test_detail::failures) {
+        std::cerr << name << ": провалено проверок: " << test_detail::failures << std::endl;
+        return 1;
+    }
+    std::cout << name << ": ok" << std::endl;
+    return 0;
+}
+
+// Описание случая для сообщений: "{3, 5} -> 4 (1,1,1,0)".
+inline auto describe(const JugsProblem& problem) -> std::string {
+    std::ostringstream out;
+    out << "{";
+    for (size_t i = 0; i < problem.jugCount(); ++i) {
+        out << (i ? ", " : "") << problem.capacity(i);
+    }
+    const MoveCosts& costs = problem.costs();
+    out << "} -> " << problem.targetVolume() << " (" << costs.fill << "," << costs.empty << ","
+        << costs.pour << "," << costs.perLiter << ")";
+    return out.str();
+}
+
+// Модели стоимости, на которых проверяются алгоритмы: единичная, по литрам
+// и смешанные.
+inline auto testCostModels() -> std::vector<MoveCosts> {
+    return {{1, 1, 1, 0}, {0, 0, 0, 1}, {1, 1, 1, 1}, {3, 2, 1, 1}};
+}
+
+// Случайная конфигурация из jugs сосудов ёмкостью до maxCapacity; цель —
+// от 0 до наибольшей ёмкости, так что попадаются и недостижимые.
+inline auto randomProblem(std::mt19937& rng, size_t jugs, int maxCapacity, const MoveCosts& costs) -> JugsProblem {
+    std::vector<int> capacities(jugs);
+    int largest = 0;
+    for (int& capacity : capacities) {
+        capacity = 1 + static_cast<int>(rng() % static_cast<unsigned>(maxCapacity));
+        largest = std::max(largest, capacity);
+    }
+    int target = static_cast<int>(rng() % static_cast<unsigned>(largest + 1));
+    return JugsProblem(capacities, target, costs);
+}
+
+#endif